@@ -20,6 +20,7 @@
 #define GAMBATTE_H
 
 #include "inputgetter.h"
+#include "soundsink.h"
 #ifdef HAVE_NETWORK
 #include "serial_io.h"
 #endif
@@ -67,6 +68,7 @@ public:
 	  * exact time (in number of samples) at which it was drawn.
 	  *
 	  * @param videoBuf 160x144 RGB32 (native endian) video frame buffer or 0
+	  *                 to skip drawing; the LCD timing stays the same either way.
 	  * @param pitch distance in number of pixels (not bytes) from the start of one line to the next in videoBuf.
 	  * @param soundBuf buffer with space >= samples + 2064
 	  * @param soundBufSize actual size of soundBuf buffer
@@ -75,6 +77,36 @@ public:
 	  */
 	long runFor(gambatte::video_pixel_t *videoBuf, int pitch,
 			gambatte::uint_least32_t *soundBuf, std::size_t soundBufSize, unsigned &samples);
+
+	enum ObsFlag {
+		OBS_WRAM   = 1, /**< 0x2000 bytes of work RAM banks 0 and 1 (0xC000-0xDFFF in DMG mode). */
+		OBS_HRAM   = 2, /**< 0x80 bytes of high RAM and IE (0xFF80-0xFFFF). */
+		OBS_OAM    = 4, /**< 0xA0 bytes of sprite attribute memory (0xFE00-0xFE9F). */
+		OBS_SCREEN = 8  /**< OBS_SCREEN_WIDTH x OBS_SCREEN_HEIGHT video_pixel_t, every other pixel of every other line. */
+	};
+
+	enum { OBS_SCREEN_WIDTH = 160 / 2, OBS_SCREEN_HEIGHT = 144 / 2 };
+
+	/** @return number of bytes step writes to its observation buffer for the given ObsFlags. */
+	static std::size_t obsSize(unsigned obsFlags);
+
+	/** Emulates exactly 'frames' video frames with a fixed joypad state, for headless users.
+	  *
+	  * Only the last frame is rendered. Observations are written to obsBuf in ObsFlag bit order
+	  * (WRAM, HRAM, OAM, screen), sampled after the last frame has been drawn.
+	  * The input getter set with setInputGetter is not called during step.
+	  *
+	  * @param inputMask InputGetter button mask held for the duration of the step
+	  * @param frames number of video frames to emulate
+	  * @param obsFlags ObsFlag bits selecting which observations to write
+	  * @param obsBuf buffer with space for obsSize(obsFlags) bytes, or 0 if obsFlags is 0
+	  * @param soundBuf buffer receiving the stereo samples produced during the step, or 0 to skip audio
+	  *                 altogether (see setSilent). Nothing is written while silent.
+	  * @param soundBufSize size of soundBuf in stereo samples. Samples that do not fit are discarded.
+	  * @return number of stereo samples written to soundBuf
+	  */
+	std::size_t step(unsigned inputMask, unsigned frames, unsigned obsFlags, void *obsBuf,
+			gambatte::uint_least32_t *soundBuf = 0, std::size_t soundBufSize = 0);
 	
 	/** Reset to initial state.
 	  * Equivalent to reloading a ROM image, or turning a Game Boy Color off and on again.
@@ -88,6 +120,60 @@ public:
 
 	/** Sets the callback used for getting input state. */
 	void setInputGetter(InputGetter *getInput);
+
+	/**
+	  * By default the input getter is called at the start of every runFor, as well as
+	  * whenever the game selects or reads the joypad lines (FF00). With lazy input only
+	  * the latter remain, so input can be sampled as late as the game looks at it.
+	  * While the joypad interrupt is enabled the getter is still called on every runFor,
+	  * since the interrupt is what such a game waits for before reading FF00.
+	  * Off by default.
+	  */
+	void setLazyInput(bool enable);
+
+	/**
+	  * When silent, the sound channels only keep track of what the game can observe
+	  * (length counters, envelopes, sweep, noise and wave positions) and no samples are
+	  * synthesized. runFor still counts samples as usual, but leaves soundBuf untouched,
+	  * and soundBufSize does not limit the count. Switch it between runFor calls.
+	  * step is always silent when given no soundBuf. Off by default.
+	  */
+	void setSilent(bool silent);
+
+	/** Returns the setting last made with setSilent. */
+	bool isSilent() const;
+
+	/**
+	  * Sends the sound output to sink as a series of timed steps instead of samples,
+	  * for resampling with band-limited steps without going through a buffer at the
+	  * native rate. While a sink is set, runFor counts samples as usual but leaves
+	  * soundBuf untouched, and soundBufSize does not limit the count. Nothing reaches
+	  * the sink while silent, nor during step. 0 goes back to filling soundBuf.
+	  * Switch it between runFor calls.
+	  */
+	void setSoundSink(SoundSink *sink);
+
+	/**
+	  * Also has runFor write the output of each sound channel on its own, to
+	  * stems[0] (channel 1) to stems[3] (channel 4), sample for sample alongside
+	  * soundBuf, packed the same way, with NR50 volume and NR51 panning applied.
+	  * The four add up to soundBuf. Each needs room for soundBufSize samples, and
+	  * is written in place, without going through any other buffer. This works with
+	  * a sink set too, in which case soundBufSize limits the sample count again.
+	  * Nothing is written while silent, nor during step. 0 turns it off.
+	  * Switch it between runFor calls.
+	  */
+	void setSoundStems(uint_least32_t *const *stems);
+
+	/**
+	  * Returns true if the sound output held one level for the whole of the last
+	  * runFor call, as it does while the APU is off or every channel's DAC is, and
+	  * stores that level, packed the same way as soundBuf samples, in level.
+	  * soundBuf is filled with it all the same, without going through the usual
+	  * mixing, but a resampler can take a flat chunk in one go. Not meaningful in
+	  * silent mode.
+	  */
+	bool soundIsFlat(uint_least32_t &level) const;
    
    /** Sets the callback used for getting the bootloader data. */
    void setBootloaderGetter(bool (*getter)(void *userdata, bool isgbc, uint8_t *data, uint32_t buf_size));
@@ -95,8 +181,25 @@ public:
 #ifdef HAVE_NETWORK
 	/** Sets the callback used for transferring serial data. */
 	void setSerialIO(SerialIO *serial_io);
+
+	/**
+	  * Sets how often SerialIO::check is polled while the game waits for the other
+	  * side to clock a transfer (SC bit 7 set, external clock). No polling is done
+	  * otherwise. The default is 256.
+	  *
+	  * @param cycles polling period in 4194304 Hz cycles
+	  */
+	void setSerialPollPeriod(unsigned cycles);
 #endif
 	
+	/**
+	  * Makes the cartridge clock (MBC3 RTC, HuC3) count emulated time instead of
+	  * host time. It starts from the host time when enabled and from there on only
+	  * advances as emulated cycles do, 4194304 a second, whatever the emulation
+	  * speed. It is saved in savestates. Off by default.
+	  */
+	void setEmulatedRtc(bool enable);
+
 	/** Sets the directory used for storing save data. The default is the same directory as the ROM Image file. */
 	void setSaveDir(const std::string &sdir);
 
@@ -119,6 +222,18 @@ public:
    bool loadState(const void *data, size_t size);
    size_t stateSize() const;
 
+	/**
+	  * Snapshots are a fast alternative to savestates for going back in time within
+	  * a session, like run-ahead does every frame: a plain copy of the emulation
+	  * state, without the tagged format. They can only be loaded back into the same
+	  * instance with the same ROM loaded, and are not meant to be stored.
+	  *
+	  * @param data buffer of snapshotSize() bytes
+	  */
+	void saveSnapshot(void *data);
+	void loadSnapshot(void const *data);
+	std::size_t snapshotSize() const;
+
    void setColorCorrection(bool enable);
    void setColorCorrectionMode(unsigned colorCorrectionMode);
    void setColorCorrectionBrightness(float colorCorrectionBrightness);
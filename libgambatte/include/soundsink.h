@@ -0,0 +1,37 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef GAMBATTE_SOUNDSINK_H
+#define GAMBATTE_SOUNDSINK_H
+
+namespace gambatte {
+
+// Gets the sound output as the steps in it rather than as samples, for
+// band-limited synthesis straight at the output rate.
+class SoundSink {
+public:
+	virtual ~SoundSink() {}
+
+	// The output changes by left and right at sample time, counted in samples
+	// since the start of the current runFor call. Steps arrive in order of time
+	// for each sound channel, but the channels take turns, so not in order
+	// overall. Deltas add up to the samples runFor would otherwise have produced.
+	virtual void addDelta(unsigned long time, int left, int right) = 0;
+};
+
+}
+
+#endif
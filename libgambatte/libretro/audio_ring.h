@@ -0,0 +1,89 @@
+#ifndef _AUDIO_RING_H
+#define _AUDIO_RING_H
+
+// Lock-free single-producer single-consumer ring of stereo frames, which
+// hands the resampled audio from retro_run to a frontend that asks for it
+// on its own audio thread. Only the indices are shared, so the compiler
+// builtins are all it needs; no threading library comes into it.
+
+#include <stdint.h>
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(_MSC_VER)
+static inline unsigned audio_ring_load(const unsigned* p)
+{
+	unsigned const v = *static_cast<const volatile unsigned*>(p);
+	_ReadWriteBarrier();
+	return v;
+}
+static inline void audio_ring_store(unsigned* p, unsigned v)
+{
+	_ReadWriteBarrier();
+	*static_cast<volatile unsigned*>(p) = v;
+}
+#elif defined(__GNUC__)
+static inline unsigned audio_ring_load(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void audio_ring_store(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+#else
+// No threads to order against on the targets left over.
+static inline unsigned audio_ring_load(const unsigned* p) { return *p; }
+static inline void audio_ring_store(unsigned* p, unsigned v) { *p = v; }
+#endif
+
+// frames must be a power of two. Exactly one thread pushes and exactly one
+// thread pops.
+template<unsigned frames>
+class AudioRing
+{
+	public:
+		AudioRing() { clear(); }
+
+		// Only while neither end is in use.
+		void clear()
+		{
+			head_ = 0;
+			tail_ = 0;
+		}
+
+		// Copies in up to n frames and returns how many fit. What does not
+		// fit is dropped: the consumer is behind, and older audio going out
+		// first is what keeps the latency down.
+		unsigned push(const int16_t* data, unsigned n)
+		{
+			unsigned const head = head_;
+			unsigned const space = frames - (head - audio_ring_load(&tail_));
+			if (n > space)
+				n = space;
+
+			unsigned const first = frames - head % frames < n ? frames - head % frames : n;
+			memcpy(buf_ + 2 * (head % frames), data, first * 2 * sizeof(*data));
+			memcpy(buf_, data + 2 * first, (n - first) * 2 * sizeof(*data));
+			audio_ring_store(&head_, head + n);
+			return n;
+		}
+
+		// Copies out up to n frames and returns how many there were.
+		unsigned pop(int16_t* data, unsigned n)
+		{
+			unsigned const tail = tail_;
+			unsigned const avail = audio_ring_load(&head_) - tail;
+			if (n > avail)
+				n = avail;
+
+			unsigned const first = frames - tail % frames < n ? frames - tail % frames : n;
+			memcpy(data, buf_ + 2 * (tail % frames), first * 2 * sizeof(*data));
+			memcpy(data + 2 * first, buf_, (n - first) * 2 * sizeof(*data));
+			audio_ring_store(&tail_, tail + n);
+			return n;
+		}
+
+	private:
+		unsigned head_;
+		unsigned tail_;
+		int16_t buf_[2 * frames];
+};
+
+#endif
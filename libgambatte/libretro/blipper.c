@@ -46,6 +46,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIPPER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BLIPPER_NEON
+#include <arm_neon.h>
+#endif
+
 struct blipper
 {
    blipper_long_sample_t *output_buffer;
@@ -53,13 +61,17 @@ struct blipper
    unsigned output_buffer_samples;
 
    const blipper_sample_t *filter_bank;
+   /* Stereo only: the filter bank with every tap twice in a row, to
+    * line up with the interleaved output buffer */
+   blipper_sample_t *stereo_filter_bank;
 
    unsigned phase;
    unsigned phases;
    unsigned phases_log2;
    unsigned taps;
+   unsigned channels;
 
-   blipper_long_sample_t integrator;
+   blipper_long_sample_t integrator[2];
    blipper_sample_t last_sample;
 };
 
@@ -68,7 +80,9 @@ void blipper_free(blipper_t *blip)
    if (blip)
    {
       /* The filter bank is const static storage (see
-       * blipper_filter_bank.h) or caller-owned; blipper never owns it. */
+       * blipper_filter_bank.h) or caller-owned; blipper never owns it.
+       * The interleaved copy of it for stereo is its own. */
+      free(blip->stereo_filter_bank);
       free(blip->output_buffer);
       free(blip);
    }
@@ -100,16 +114,17 @@ static unsigned log2_int(unsigned v)
 void blipper_reset(blipper_t *blip)
 {
    blip->phase = 0;
-   memset(blip->output_buffer, 0,
-         (blip->output_avail + blip->taps) * sizeof(*blip->output_buffer));
+   memset(blip->output_buffer, 0, (blip->output_avail + blip->taps)
+         * blip->channels * sizeof(*blip->output_buffer));
    blip->output_avail = 0;
    blip->last_sample = 0;
-   blip->integrator = 0;
+   blip->integrator[0] = 0;
+   blip->integrator[1] = 0;
 }
 
-blipper_t *blipper_new(unsigned taps, double cutoff, double beta,
-      unsigned decimation, unsigned buffer_samples,
-      const blipper_sample_t *filter_bank)
+static blipper_t *blipper_create(unsigned channels, unsigned taps,
+      double cutoff, double beta, unsigned decimation,
+      unsigned buffer_samples, const blipper_sample_t *filter_bank)
 {
    blipper_t *blip = NULL;
 
@@ -136,9 +151,26 @@ blipper_t *blipper_new(unsigned taps, double cutoff, double beta,
    blip->phases      = decimation;
    blip->phases_log2 = log2_int(decimation);
    blip->taps        = taps;
+   blip->channels    = channels;
    blip->filter_bank = filter_bank;
 
-   blip->output_buffer = (blipper_long_sample_t*)calloc(buffer_samples + blip->taps,
+   if (channels == 2)
+   {
+      unsigned i;
+
+      blip->stereo_filter_bank = (blipper_sample_t*)malloc(decimation * taps * 2
+            * sizeof(*blip->stereo_filter_bank));
+      if (!blip->stereo_filter_bank)
+         goto error;
+
+      for (i = 0; i < decimation * taps; i++)
+      {
+         blip->stereo_filter_bank[2 * i]     = filter_bank[i];
+         blip->stereo_filter_bank[2 * i + 1] = filter_bank[i];
+      }
+   }
+
+   blip->output_buffer = (blipper_long_sample_t*)calloc((buffer_samples + blip->taps) * channels,
          sizeof(*blip->output_buffer));
    if (!blip->output_buffer)
       goto error;
@@ -151,6 +183,22 @@ error:
    return NULL;
 }
 
+blipper_t *blipper_new(unsigned taps, double cutoff, double beta,
+      unsigned decimation, unsigned buffer_samples,
+      const blipper_sample_t *filter_bank)
+{
+   return blipper_create(1, taps, cutoff, beta, decimation,
+         buffer_samples, filter_bank);
+}
+
+blipper_t *blipper_new_stereo(unsigned taps, double cutoff, double beta,
+      unsigned decimation, unsigned buffer_samples,
+      const blipper_sample_t *filter_bank)
+{
+   return blipper_create(2, taps, cutoff, beta, decimation,
+         buffer_samples, filter_bank);
+}
+
 void blipper_push_delta(blipper_t *blip, blipper_long_sample_t delta, unsigned clocks_step)
 {
    unsigned target_output, filter_phase, taps, i;
@@ -198,26 +246,123 @@ void blipper_push_samples(blipper_t *blip, const blipper_sample_t *data,
    blip->last_sample = last;
 }
 
+void blipper_add_delta(blipper_t *blip, blipper_long_sample_t delta, unsigned clocks)
+{
+   unsigned phase, target_output, filter_phase, taps, i;
+   const blipper_sample_t *response;
+   blipper_long_sample_t *target;
+
+   phase = blip->phase + clocks;
+
+   target_output = (phase + blip->phases - 1) >> blip->phases_log2;
+
+   filter_phase = (target_output << blip->phases_log2) - phase;
+   response = blip->filter_bank + blip->taps * filter_phase;
+
+   target = blip->output_buffer + target_output;
+   taps = blip->taps;
+
+   for (i = 0; i < taps; i++)
+      target[i] += delta * response[i];
+}
+
+/* Adds n / 2 taps times each channel's delta into the interleaved
+ * output. taps holds every tap twice in a row, so one pass covers both
+ * channels. The vector versions take 4 taps (8 words) at a time, which
+ * every supported tap count is a multiple of. */
+#if defined(BLIPPER_SSE2)
+static void blipper_fir_stereo(blipper_long_sample_t *out,
+      const blipper_sample_t *taps, unsigned n,
+      blipper_long_sample_t left, blipper_long_sample_t right)
+{
+   /* 16x16 products come out as low and high halves, which interleave
+    * back into 32-bit words */
+   __m128i const delta = _mm_set1_epi32((int32_t)((uint32_t)(uint16_t)left | (uint32_t)right << 16));
+   unsigned i;
+
+   for (i = 0; i < n; i += 8)
+   {
+      __m128i const k  = _mm_loadu_si128((const __m128i*)(taps + i));
+      __m128i const lo = _mm_mullo_epi16(delta, k);
+      __m128i const hi = _mm_mulhi_epi16(delta, k);
+      __m128i *const o = (__m128i*)(out + i);
+
+      _mm_storeu_si128(o,     _mm_add_epi32(_mm_loadu_si128(o),     _mm_unpacklo_epi16(lo, hi)));
+      _mm_storeu_si128(o + 1, _mm_add_epi32(_mm_loadu_si128(o + 1), _mm_unpackhi_epi16(lo, hi)));
+   }
+}
+#elif defined(BLIPPER_NEON)
+static void blipper_fir_stereo(blipper_long_sample_t *out,
+      const blipper_sample_t *taps, unsigned n,
+      blipper_long_sample_t left, blipper_long_sample_t right)
+{
+   int32_t const pair[4] = { left, right, left, right };
+   int32x4_t const delta = vld1q_s32(pair);
+   unsigned i;
+
+   for (i = 0; i < n; i += 8)
+   {
+      int16x8_t const k = vld1q_s16(taps + i);
+      vst1q_s32(out + i,     vmlaq_s32(vld1q_s32(out + i),     vmovl_s16(vget_low_s16(k)),  delta));
+      vst1q_s32(out + i + 4, vmlaq_s32(vld1q_s32(out + i + 4), vmovl_s16(vget_high_s16(k)), delta));
+   }
+}
+#else
+static void blipper_fir_stereo(blipper_long_sample_t *out,
+      const blipper_sample_t *taps, unsigned n,
+      blipper_long_sample_t left, blipper_long_sample_t right)
+{
+   unsigned i;
+
+   for (i = 0; i < n; i += 2)
+   {
+      out[i]     += left  * taps[i];
+      out[i + 1] += right * taps[i + 1];
+   }
+}
+#endif
+
+void blipper_add_delta_stereo(blipper_t *blip, blipper_long_sample_t left,
+      blipper_long_sample_t right, unsigned clocks)
+{
+   unsigned phase, target_output, filter_phase;
+
+   phase = blip->phase + clocks;
+
+   target_output = (phase + blip->phases - 1) >> blip->phases_log2;
+
+   filter_phase = (target_output << blip->phases_log2) - phase;
+
+   blipper_fir_stereo(blip->output_buffer + 2 * target_output,
+         blip->stereo_filter_bank + 2 * blip->taps * filter_phase,
+         2 * blip->taps, left, right);
+}
+
+void blipper_advance(blipper_t *blip, unsigned clocks)
+{
+   blip->phase += clocks;
+   blip->output_avail = (blip->phase + blip->phases - 1) >> blip->phases_log2;
+}
+
 unsigned blipper_read_avail(blipper_t *blip)
 {
    return blip->output_avail;
 }
 
-void blipper_read(blipper_t *blip, blipper_sample_t *output, unsigned samples,
-      unsigned stride)
+static blipper_long_sample_t blipper_integrate(blipper_long_sample_t sum,
+      const blipper_long_sample_t *out, blipper_sample_t *output,
+      unsigned samples, unsigned in_stride, unsigned stride)
 {
    unsigned s;
-   blipper_long_sample_t sum = blip->integrator;
-   const blipper_long_sample_t *out = blip->output_buffer;
 
-   for (s = 0; s < samples; s++, output += stride)
+   for (s = 0; s < samples; s++, out += in_stride, output += stride)
    {
       blipper_long_sample_t quant;
 
       /* Cannot overflow. Also add a leaky integrator.
          Mitigates DC shift numerical instability which is
          inherent for integrators. */
-      sum += (out[s] >> 1) - (sum >> 9);
+      sum += (*out >> 1) - (sum >> 9);
 
       /* Rounded. With leaky integrator, this cannot overflow. */
       quant = (sum + 0x4000) >> 15;
@@ -233,13 +378,38 @@ void blipper_read(blipper_t *blip, blipper_sample_t *output, unsigned samples,
       *output = quant;
    }
 
+   return sum;
+}
+
+static void blipper_consume(blipper_t *blip, unsigned samples)
+{
+   unsigned const channels = blip->channels;
+   unsigned const kept     = blip->output_avail + blip->taps - samples;
+
    /* Don't bother with ring buffering.
     * The entire buffer should be read out ideally anyways. */
-   memmove(blip->output_buffer, blip->output_buffer + samples,
-         (blip->output_avail + blip->taps - samples) * sizeof(*out));
-   memset(blip->output_buffer + blip->taps, 0, samples * sizeof(*out));
+   memmove(blip->output_buffer, blip->output_buffer + samples * channels,
+         kept * channels * sizeof(*blip->output_buffer));
+   memset(blip->output_buffer + kept * channels, 0,
+         samples * channels * sizeof(*blip->output_buffer));
    blip->output_avail -= samples;
    blip->phase -= samples << blip->phases_log2;
+}
 
-   blip->integrator = sum;
+void blipper_read(blipper_t *blip, blipper_sample_t *output, unsigned samples,
+      unsigned stride)
+{
+   blip->integrator[0] = blipper_integrate(blip->integrator[0],
+         blip->output_buffer, output, samples, 1, stride);
+   blipper_consume(blip, samples);
+}
+
+void blipper_read_stereo(blipper_t *blip, blipper_sample_t *output,
+      unsigned samples)
+{
+   blip->integrator[0] = blipper_integrate(blip->integrator[0],
+         blip->output_buffer, output, samples, 2, 2);
+   blip->integrator[1] = blipper_integrate(blip->integrator[1],
+         blip->output_buffer + 1, output + 1, samples, 2, 2);
+   blipper_consume(blip, samples);
 }
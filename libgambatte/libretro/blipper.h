@@ -79,6 +79,14 @@ typedef int32_t blipper_long_sample_t;
 blipper_t *blipper_new(unsigned taps, double cutoff, double beta,
       unsigned decimation, unsigned buffer_samples, const blipper_sample_t *filter_bank);
 
+/* Create a blipper for interleaved stereo, which runs both channels
+ * through one filter pass. Same parameters as blipper_new(). Fed with
+ * blipper_add_delta_stereo() and read with blipper_read_stereo(); the
+ * mono push/add/read functions are not to be used with it.
+ */
+blipper_t *blipper_new_stereo(unsigned taps, double cutoff, double beta,
+      unsigned decimation, unsigned buffer_samples, const blipper_sample_t *filter_bank);
+
 /* Reset the blipper to its initiate state. */
 void blipper_reset(blipper_t *blip);
 
@@ -116,6 +124,26 @@ void blipper_push_delta(blipper_t *blip, blipper_long_sample_t delta, unsigned c
 void blipper_push_samples(blipper_t *blip, const blipper_sample_t *delta,
       unsigned samples, unsigned stride);
 
+/* Add a delta at clocks input samples past the current position, without
+ * moving the position. Deltas can come in any order, as long as none of
+ * them lands before the current position, so several sources can be
+ * added one after another. Follow up with blipper_advance().
+ * Not to be mixed with blipper_push_samples().
+ */
+void blipper_add_delta(blipper_t *blip, blipper_long_sample_t delta, unsigned clocks);
+
+/* As blipper_add_delta(), for a stereo blipper: one delta per channel,
+ * both of which must fit in int16. On SSE2 and NEON targets the taps
+ * are applied with vector instructions, with the same result.
+ */
+void blipper_add_delta_stereo(blipper_t *blip, blipper_long_sample_t left,
+      blipper_long_sample_t right, unsigned clocks);
+
+/* Move the position forward by clocks input samples, past the deltas
+ * added with blipper_add_delta(), making them available for reading.
+ */
+void blipper_advance(blipper_t *blip, unsigned clocks);
+
 /* Returns the number of samples available for reading using
  * blipper_read().
  */
@@ -130,6 +158,12 @@ unsigned blipper_read_avail(blipper_t *blip);
 void blipper_read(blipper_t *blip, blipper_sample_t *output, unsigned samples,
       unsigned stride);
 
+/* Reads processed samples of a stereo blipper into an interleaved
+ * stereo buffer. The same restriction as blipper_read() applies.
+ */
+void blipper_read_stereo(blipper_t *blip, blipper_sample_t *output,
+      unsigned samples);
+
 #ifdef __cplusplus
 }
 #endif
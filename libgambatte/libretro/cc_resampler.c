@@ -122,6 +122,22 @@ void CC_renderaudio(audio_frame_t* sound_buf, unsigned samples)
    if (write_pos > 0)
       audio_out_buffer_write((int16_t*)out_buf, write_pos);
 }
+
+void CC_renderflat(audio_frame_t level, unsigned samples)
+{
+   audio_frame_t block[256];
+   unsigned i;
+
+   for (i = 0; i < 256; i++)
+      block[i] = level;
+
+   while (samples)
+   {
+      unsigned n = samples < 256 ? samples : 256;
+      CC_renderaudio(block, n);
+      samples -= n;
+   }
+}
 #else /* !_MIPS_ARCH_ALLEGREX */
 
 #ifndef CC_RESAMPLER_NO_HIGHPASS
@@ -151,24 +167,53 @@ void CC_init(void)
    CC_next_r    = 0;
 }
 
-void CC_renderaudio(audio_frame_t* sound_buf, unsigned samples)
+static const int16_t CC_kernel[32]=
+{
+   0x0800, 0x07fb, 0x07eb, 0x07d3, 0x07b3, 0x0787, 0x0753, 0x0717,
+   0x06d3, 0x068b, 0x063b, 0x05e2, 0x0586, 0x052a, 0x04c6, 0x0466,
+   0x0402, 0x0399, 0x0339, 0x02d5, 0x0279, 0x021d, 0x01c4, 0x0174,
+   0x012c, 0x00e8, 0x00ac, 0x0078, 0x004c, 0x002c, 0x0014, 0x0004
+};
+static const int16_t CC_kernel_r[32]=
+{
+   0x0000, 0x0004, 0x0014, 0x002c, 0x004c, 0x0078, 0x00ac, 0x00e8,
+   0x012c, 0x0174, 0x01c4, 0x021d, 0x0279, 0x02d5, 0x0339, 0x0399,
+   0x0402, 0x0466, 0x04c6, 0x052a, 0x0586, 0x05e2, 0x063b, 0x068b,
+   0x06d3, 0x0717, 0x0753, 0x0787, 0x07b3, 0x07d3, 0x07eb, 0x07fb
+};
+
+/* Sums of the kernels above */
+#define CC_KERNEL_SUM   0x83f3
+#define CC_KERNEL_R_SUM 0x7bf3
+
+static int16_t CC_out_buf[2048];
+
+static void CC_output(int16_t *out, int32_t current_l, int32_t current_r)
 {
-   static const int16_t CC_kernel[32]=
+#ifdef CC_RESAMPLER_NO_HIGHPASS
+   out[0] = (current_l>>16);
+   out[1] = (current_r>>16);
+#else
    {
-      0x0800, 0x07fb, 0x07eb, 0x07d3, 0x07b3, 0x0787, 0x0753, 0x0717,
-      0x06d3, 0x068b, 0x063b, 0x05e2, 0x0586, 0x052a, 0x04c6, 0x0466,
-      0x0402, 0x0399, 0x0339, 0x02d5, 0x0279, 0x021d, 0x01c4, 0x0174,
-      0x012c, 0x00e8, 0x00ac, 0x0078, 0x004c, 0x002c, 0x0014, 0x0004
-   };
-   static const int16_t CC_kernel_r[32]=
+      int16_t sample_l = (current_l>>16);
+      int32_t tmp_l = CC_highpass_l + ((sample_l-CC_prevsmpl_l)<<8);
+      CC_highpass_l = tmp_l - (tmp_l>>8);
+      CC_prevsmpl_l = sample_l;
+      out[0] = ((CC_highpass_l+128)>>8);
+   }
    {
-      0x0000, 0x0004, 0x0014, 0x002c, 0x004c, 0x0078, 0x00ac, 0x00e8,
-      0x012c, 0x0174, 0x01c4, 0x021d, 0x0279, 0x02d5, 0x0339, 0x0399,
-      0x0402, 0x0466, 0x04c6, 0x052a, 0x0586, 0x05e2, 0x063b, 0x068b,
-      0x06d3, 0x0717, 0x0753, 0x0787, 0x07b3, 0x07d3, 0x07eb, 0x07fb
-   };
+      int16_t sample_r = (current_r>>16);
+      int32_t tmp_r = CC_highpass_r + ((sample_r-CC_prevsmpl_r)<<8);
+      CC_highpass_r = tmp_r - (tmp_r>>8);
+      CC_prevsmpl_r = sample_r;
+      out[1] = ((CC_highpass_r+128)>>8);
+   }
+#endif
+}
 
-   static int16_t out_buf[2048];
+void CC_renderaudio(audio_frame_t* sound_buf, unsigned samples)
+{
+   int16_t *out_buf = CC_out_buf;
    unsigned i;
 
    unsigned int accumulated_samples = CC_accumulated_samples;
@@ -188,25 +233,8 @@ void CC_renderaudio(audio_frame_t* sound_buf, unsigned samples)
       accumulated_samples++;
       if (accumulated_samples == 32)
       {
-#ifdef CC_RESAMPLER_NO_HIGHPASS
-         out_buf[write_pos++] = (current_l>>16);
-         out_buf[write_pos++] = (current_r>>16);
-#else
-         {
-            int16_t sample_l = (current_l>>16);
-            int32_t tmp_l = CC_highpass_l + ((sample_l-CC_prevsmpl_l)<<8);
-            CC_highpass_l = tmp_l - (tmp_l>>8);
-            CC_prevsmpl_l = sample_l;
-            out_buf[write_pos++] = ((CC_highpass_l+128)>>8);
-         }
-         {
-            int16_t sample_r = (current_r>>16);
-            int32_t tmp_r = CC_highpass_r + ((sample_r-CC_prevsmpl_r)<<8);
-            CC_highpass_r = tmp_r - (tmp_r>>8);
-            CC_prevsmpl_r = sample_r;
-            out_buf[write_pos++] = ((CC_highpass_r+128)>>8);
-         }
-#endif
+         CC_output(out_buf + write_pos, current_l, current_r);
+         write_pos += 2;
          accumulated_samples = 0;
          current_l = next_l;
          current_r = next_r;
@@ -230,4 +258,56 @@ void CC_renderaudio(audio_frame_t* sound_buf, unsigned samples)
    CC_next_l    = next_l;
    CC_next_r    = next_r;
 }
+
+void CC_renderflat(audio_frame_t level, unsigned samples)
+{
+   int16_t *out_buf = CC_out_buf;
+   unsigned int write_pos = 0;
+
+   /* Whole blocks of a constant input add up to the
+    * kernel sums times the level, which gives the same
+    * output as CC_renderaudio() one output sample at a
+    * time instead of one input sample */
+   while (samples)
+   {
+      if (CC_accumulated_samples == 0 && samples >= 32)
+      {
+         CC_output(out_buf + write_pos,
+               CC_current_l + level.l * CC_KERNEL_SUM,
+               CC_current_r + level.r * CC_KERNEL_SUM);
+         write_pos += 2;
+         CC_current_l = level.l * CC_KERNEL_R_SUM;
+         CC_current_r = level.r * CC_KERNEL_R_SUM;
+         samples  -= 32;
+
+         if (write_pos == 2048)
+         {
+            audio_out_buffer_write(out_buf, 1024);
+            write_pos = 0;
+         }
+      }
+      else
+      {
+         /* Partial blocks at either end */
+         unsigned n = 32 - CC_accumulated_samples;
+         audio_frame_t block[32];
+         unsigned i;
+
+         if (n > samples)
+            n = samples;
+         for (i = 0; i < n; i++)
+            block[i] = level;
+
+         if (write_pos > 0)
+            audio_out_buffer_write(out_buf, write_pos >> 1);
+         write_pos = 0;
+
+         CC_renderaudio(block, n);
+         samples -= n;
+      }
+   }
+
+   if (write_pos > 0)
+      audio_out_buffer_write(out_buf, write_pos >> 1);
+}
 #endif /* _MIPS_ARCH_ALLEGREX */
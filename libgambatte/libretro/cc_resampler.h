@@ -36,6 +36,8 @@ extern void audio_out_buffer_write(int16_t *samples, size_t num_samples);
 
 void CC_init(void);
 void CC_renderaudio(audio_frame_t *sound_buf, unsigned samples);
+/* Same as CC_renderaudio() over samples copies of level */
+void CC_renderflat(audio_frame_t level, unsigned samples);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,263 @@
+#include "dual_link.h"
+#include "libretro.h"
+#include "gambatte_log.h"
+#include <string.h>
+
+// Message layout: bit 31 marks a request (the sender drives the clock),
+// bits 16-30 hold the request sequence number, bit 8 the CGB fast clock
+// flag and bits 0-7 the data byte.
+enum {
+	link_request  = 0x80000000u,
+	link_seq_mask = 0x7FFF0000u,
+	link_fast     = 0x100
+};
+
+LinkPort::LinkPort()
+: peer_(0)
+, pending_(0)
+, seq_(0)
+, frames_(0)
+, waiting_(0)
+, stopped_(0)
+{
+}
+
+void LinkPort::connect(LinkPort* peer)
+{
+	peer_ = peer;
+}
+
+void LinkPort::reset()
+{
+	in_.clear();
+	pending_ = 0;
+	seq_ = 0;
+	frames_ = 0;
+	waiting_ = 0;
+	stopped_ = 0;
+}
+
+void LinkPort::stop()
+{
+	link_store(&stopped_, 1);
+}
+
+void LinkPort::frameDone()
+{
+	link_store(&frames_, frames_ + 1);
+}
+
+bool LinkPort::waiting() const
+{
+	return link_load(&waiting_) != 0;
+}
+
+unsigned LinkPort::frames() const
+{
+	return link_load(&frames_);
+}
+
+// A request stays open in the sender's pending_ slot until either the
+// receiver claims it or the sender gives up on it, whichever comes first.
+bool LinkPort::claim(unsigned msg)
+{
+	return link_cas(&peer_->pending_, msg, 0);
+}
+
+void LinkPort::answer(unsigned msg, unsigned char out)
+{
+	unsigned spins = 0;
+
+	// The peer drains its channel until it sees this reply, so a full
+	// channel only ever lasts until its next pop.
+	while (!peer_->in_.push((msg & link_seq_mask) | out))
+		link_relax(spins);
+}
+
+bool LinkPort::check(unsigned char out, unsigned char& in, bool& fastCgb)
+{
+	unsigned msg;
+
+	// Stale replies and requests the sender already gave up on are dropped.
+	while (in_.pop(msg)) {
+		if ((msg & link_request) && claim(msg)) {
+			answer(msg, out);
+			in = msg & 0xFF;
+			fastCgb = (msg & link_fast) != 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned char LinkPort::send(unsigned char data, bool fastCgb)
+{
+	if (peer_ == 0 || link_load(&stopped_))
+		return 0xFF;
+
+	seq_ = seq_ % 0x7FFF + 1;
+	unsigned const msg = link_request | seq_ << 16 | (fastCgb ? link_fast : 0) | data;
+	link_store(&pending_, msg);
+	if (!peer_->in_.push(msg)) {
+		link_store(&pending_, 0);
+		return 0xFF;
+	}
+
+	unsigned const start = peer_->frames();
+	unsigned char reply = 0xFF;
+	unsigned spins = 0;
+
+	link_store(&waiting_, 1);
+	for (;;) {
+		unsigned in;
+		if (in_.pop(in)) {
+			if (in & link_request) {
+				// Both consoles are driving the clock, so neither
+				// shifts in anything the other one sent.
+				if (claim(in))
+					answer(in, 0xFF);
+			} else if ((in & link_seq_mask) == (msg & link_seq_mask)) {
+				reply = in & 0xFF;
+				break;
+			}
+			continue;
+		}
+		// Give up once the peer has run two frames without listening,
+		// unless it claimed the request meanwhile and the reply is in flight.
+		if ((link_load(&stopped_) || peer_->frames() - start >= 2)
+				&& link_cas(&pending_, msg, 0)) {
+			break;
+		}
+		link_relax(spins);
+	}
+	link_store(&waiting_, 0);
+
+	return reply;
+}
+
+DualRunner::DualRunner()
+: gb_(0)
+, port_(0)
+, peer_(0)
+, quit_(0)
+, target_(0)
+, done_(0)
+, input_(0)
+, frameInput_(0)
+, lock_(0)
+{
+}
+
+DualRunner::~DualRunner()
+{
+	stop();
+}
+
+bool DualRunner::start(gambatte::GB* gb, LinkPort* port, LinkPort* peer)
+{
+	stop();
+
+	gb_ = gb;
+	port_ = port;
+	peer_ = peer;
+	port_->reset();
+	peer_->reset();
+	port_->connect(peer_);
+	peer_->connect(port_);
+	gb_->setInputGetter(this);
+	gb_->setSerialIO(port_);
+
+	quit_ = 0;
+	target_ = 0;
+	done_ = 0;
+	input_ = 0;
+	frameInput_ = 0;
+	lock_ = 0;
+	memset(front_, 0, sizeof front_);
+
+	if (!thread_.start(entry, this)) {
+		gambatte_log(RETRO_LOG_ERROR, "Could not start second Game Boy thread.\n");
+		return false;
+	}
+
+	return true;
+}
+
+void DualRunner::stop()
+{
+	if (!thread_.running())
+		return;
+
+	link_store(&quit_, 1);
+	port_->stop();
+	peer_->stop();
+	thread_.join();
+}
+
+void DualRunner::beginFrame(unsigned input)
+{
+	link_store(&input_, input);
+	link_store(&target_, target_ + 1);
+}
+
+void DualRunner::endFrame(gambatte::video_pixel_t* dst, std::ptrdiff_t pitch)
+{
+	unsigned spins = 0;
+
+	// Don't wait for a worker that is itself blocked on this console:
+	// it cannot finish its frame before our next one runs.
+	while (thread_.running() && static_cast<int>(link_load(&done_) - target_) < 0 && !port_->waiting())
+		link_relax(spins);
+
+	spins = 0;
+	while (!link_cas(&lock_, 0, 1))
+		link_relax(spins);
+	for (unsigned y = 0; y < height; ++y)
+		memcpy(dst + y * pitch, front_ + y * width, width * sizeof *dst);
+	link_store(&lock_, 0);
+
+	peer_->frameDone();
+}
+
+unsigned DualRunner::operator()()
+{
+	return frameInput_;
+}
+
+void DualRunner::entry(void* self)
+{
+	static_cast<DualRunner*>(self)->run();
+}
+
+void DualRunner::run()
+{
+	while (!link_load(&quit_)) {
+		unsigned spins = 0;
+
+		while (!link_load(&quit_)
+				&& static_cast<int>(done_ - link_load(&target_)) >= 0
+				&& !peer_->waiting()) {
+			link_relax(spins);
+		}
+		if (link_load(&quit_))
+			break;
+
+		frameInput_ = link_load(&input_);
+		for (;;) {
+			unsigned samples = sound_buf_size / 2;
+			if (gb_->runFor(render_, width, sound_, sound_buf_size, samples) != -1
+					|| link_load(&quit_)) {
+				break;
+			}
+		}
+
+		spins = 0;
+		while (!link_cas(&lock_, 0, 1))
+			link_relax(spins);
+		memcpy(front_, render_, sizeof front_);
+		link_store(&lock_, 0);
+
+		port_->frameDone();
+		link_store(&done_, done_ + 1);
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef _DUAL_LINK_H
+#define _DUAL_LINK_H
+
+#include <gambatte.h>
+#include <cstddef>
+#include "link_sync.h"
+
+// One end of an in-process link cable. Each console owns one port and only
+// calls into it from its own thread; the two ports talk through a pair of
+// SPSC channels, so the consoles only meet when a byte is transferred.
+class LinkPort : public gambatte::SerialIO
+{
+	public:
+		LinkPort();
+
+		void connect(LinkPort* peer);
+		void reset();
+		void stop();
+		void frameDone();
+		bool waiting() const;
+		unsigned frames() const;
+
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
+		virtual unsigned char send(unsigned char data, bool fastCgb);
+
+	private:
+		bool claim(unsigned msg);
+		void answer(unsigned msg, unsigned char out);
+
+		LinkPort* peer_;
+		LinkChannel<16> in_;
+		unsigned pending_;
+		unsigned seq_;
+		unsigned frames_;
+		unsigned waiting_;
+		unsigned stopped_;
+};
+
+// Runs a second GB on its own thread, one video frame at a time, paced by
+// the frontend thread through beginFrame()/endFrame(). The worker is allowed
+// to run one frame ahead, and further while the frontend console is blocked
+// waiting for a serial reply from it.
+class DualRunner : public gambatte::InputGetter
+{
+	public:
+		DualRunner();
+		~DualRunner();
+
+		bool start(gambatte::GB* gb, LinkPort* port, LinkPort* peer);
+		void stop();
+		bool running() const { return thread_.running(); }
+
+		void beginFrame(unsigned input);
+		void endFrame(gambatte::video_pixel_t* dst, std::ptrdiff_t pitch);
+
+		virtual unsigned operator()();
+
+	private:
+		enum { width = 160, height = 144, sound_buf_size = 2064 + 2064 };
+
+		static void entry(void* self);
+		void run();
+
+		gambatte::GB* gb_;
+		LinkPort* port_;
+		LinkPort* peer_;
+		unsigned quit_;
+		unsigned target_;
+		unsigned done_;
+		unsigned input_;
+		unsigned frameInput_;
+		unsigned lock_;
+		gambatte::video_pixel_t render_[width * height];
+		gambatte::video_pixel_t front_[width * height];
+		gambatte::uint_least32_t sound_[sound_buf_size];
+		LinkThread thread_;
+};
+
+#endif
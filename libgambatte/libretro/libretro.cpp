@@ -5,11 +5,20 @@
 #include "gambatte_log.h"
 #include "blipper.h"
 #include "cc_resampler.h"
+#include "polyphase.h"
+#include "audio_ring.h"
 #include "gambatte.h"
 #include "gbcpalettes.h"
 #include "bootloader.h"
 #ifdef HAVE_NETWORK
 #include "net_serial.h"
+#include "net_rollback.h"
+#endif
+#ifdef HAVE_LOCAL_LINK
+#include "shm_serial.h"
+#endif
+#ifdef DUAL_MODE
+#include "dual_link.h"
 #endif
 
 #if defined(__DJGPP__) && defined(__STRICT_ANSI__)
@@ -74,6 +83,8 @@ static bool show_gb_link_settings = true;
 #define TURBO_PULSE_WIDTH_MAX 15
 
 static unsigned libretro_input_state = 0;
+static bool lazy_input               = false;
+static bool input_sampled            = false;
 static bool up_down_allowed          = false;
 static unsigned turbo_period         = TURBO_PERIOD_MIN;
 static unsigned turbo_pulse_width    = TURBO_PULSE_WIDTH_MIN;
@@ -82,6 +93,10 @@ static unsigned turbo_b_counter      = 0;
 
 static bool rom_loaded = false;
 
+static unsigned run_ahead_frames = 0;
+static bool run_ahead_running    = false;
+static std::vector<char> run_ahead_snapshot;
+
 /* Frame-pacing counters used to detect frame dupes when the
  * emulator generates audio faster than video. Previously these
  * were function-local statics inside retro_run, which meant
@@ -100,13 +115,17 @@ static INLINE void frame_pacing_reset(void)
    libretro_frames_count  = 0;
 }
 
-//Dual mode runs two GBCs side by side.
-//Currently, they load the same ROM, take the same input, and only the left one supports SRAM, cheats, savestates, or sound.
-//Can be made useful later, but for now, it's just a tech demo.
-//#define DUAL_MODE
-
+//Dual mode runs two GBCs side by side, connected by an in-process link cable (build with DUAL_MODE=1).
+//They load the same ROM and take the same input, and only the left one supports SRAM, cheats, savestates, or sound.
+//The right one runs on its own thread; the two only synchronise when a serial transfer is started.
 #ifdef DUAL_MODE
+#ifndef HAVE_NETWORK
+#error "DUAL_MODE needs the serial I/O hooks enabled by HAVE_NETWORK"
+#endif
 static gambatte::GB gb2;
+static LinkPort gb_link_port;
+static LinkPort gb2_link_port;
+static DualRunner gb2_runner;
 #define NUM_GAMEBOYS 2
 #else
 #define NUM_GAMEBOYS 1
@@ -154,10 +173,42 @@ bool use_official_bootloader = false;
  * so add some padding and round up to (1024 + 512) */
 #define BLIP_BUFFER_SIZE (1024 + 512)
 
-static blipper_t *resampler_l = NULL;
-static blipper_t *resampler_r = NULL;
+/* The polyphase resampler produces up to ~804 output
+ * samples per frame at 48 kHz; same ~50% margin */
+#define POLYPHASE_BUFFER_SIZE 2048
+
+static blipper_t *resampler_blip = NULL;
+static polyphase_t *resampler_pp = NULL;
+
+static bool use_cc_resampler        = false;
+static bool use_polyphase_resampler = false;
+static unsigned audio_output_rate   = 48000;
+static unsigned polyphase_taps      = 16;
 
-static bool use_cc_resampler = false;
+/* Low-latency audio: GB::runFor() chunk size in native
+ * samples, each chunk's audio going out as soon as it
+ * is resampled. 0 when off. */
+static unsigned audio_chunk_samples = 0;
+
+/* ~170 ms at 48 kHz; only ever more than a frame or two
+ * full if the frontend stops pulling */
+#define AUDIO_RING_FRAMES 8192
+
+/* For frontends that take an audio callback and pull
+ * audio on their own thread */
+static AudioRing<AUDIO_RING_FRAMES> audio_ring;
+/* Set from the frontend's audio thread, hence the ring's
+ * atomics rather than a plain bool */
+static unsigned audio_callback_enabled = 0;
+
+static double audio_out_sample_rate(void)
+{
+   if (use_cc_resampler)
+      return SOUND_SAMPLE_RATE_CC;
+   if (use_polyphase_resampler)
+      return audio_output_rate;
+   return SOUND_SAMPLE_RATE_BLIPPER;
+}
 
 static int16_t *audio_out_buffer     = NULL;
 static size_t audio_out_buffer_size  = 0;
@@ -166,8 +217,7 @@ static size_t audio_batch_frames_max = (1 << 16);
 
 static void audio_out_buffer_init(void)
 {
-   float sample_rate       = use_cc_resampler ?
-         SOUND_SAMPLE_RATE_CC : SOUND_SAMPLE_RATE_BLIPPER;
+   float sample_rate       = audio_out_sample_rate();
    float samples_per_frame = sample_rate / VIDEO_REFRESH_RATE;
    size_t buffer_size      = ((size_t)samples_per_frame + 1) << 1;
 
@@ -260,8 +310,7 @@ static void audio_out_buffer_read_blipper(size_t num_samples)
       while (remaining)
       {
          size_t chunk = remaining > 32 ? 32 : remaining;
-         blipper_read(resampler_l, scratch    , chunk, 2);
-         blipper_read(resampler_r, scratch + 1, chunk, 2);
+         blipper_read_stereo(resampler_blip, scratch, chunk);
          remaining -= chunk;
       }
       return;
@@ -269,8 +318,29 @@ static void audio_out_buffer_read_blipper(size_t num_samples)
 
    audio_out_buffer_ptr = audio_out_buffer + audio_out_buffer_pos;
 
-   blipper_read(resampler_l, audio_out_buffer_ptr    , num_samples, 2);
-   blipper_read(resampler_r, audio_out_buffer_ptr + 1, num_samples, 2);
+   blipper_read_stereo(resampler_blip, audio_out_buffer_ptr, num_samples);
+
+   audio_out_buffer_pos += num_samples << 1;
+}
+
+static void audio_out_buffer_read_polyphase(size_t num_samples)
+{
+   if (!audio_out_buffer_resize(num_samples))
+   {
+      /* Out of memory: drain it anyway, as above */
+      int16_t scratch[64];
+      size_t remaining = num_samples;
+      while (remaining)
+      {
+         size_t chunk = remaining > 32 ? 32 : remaining;
+         polyphase_read(resampler_pp, scratch, chunk);
+         remaining -= chunk;
+      }
+      return;
+   }
+
+   polyphase_read(resampler_pp, audio_out_buffer + audio_out_buffer_pos,
+         num_samples);
 
    audio_out_buffer_pos += num_samples << 1;
 }
@@ -280,6 +350,14 @@ static void audio_upload_samples(void)
    int16_t *audio_out_buffer_ptr = audio_out_buffer;
    size_t num_samples            = audio_out_buffer_pos >> 1;
 
+   /* The frontend's audio thread takes it from here */
+   if (audio_ring_load(&audio_callback_enabled))
+   {
+      audio_ring.push(audio_out_buffer_ptr, num_samples);
+      audio_out_buffer_pos = 0;
+      return;
+   }
+
    while (num_samples > 0)
    {
       size_t samples_to_write = (num_samples >
@@ -300,41 +378,162 @@ static void audio_upload_samples(void)
    audio_out_buffer_pos = 0;
 }
 
-static void blipper_renderaudio(const int16_t *samples, unsigned frames)
+/* Runs on the frontend's audio thread */
+static void audio_callback(void)
 {
+   int16_t frames[2 * 256];
+   unsigned num_samples;
+
+   while ((num_samples = audio_ring.pop(frames, 256)))
+      audio_batch_cb(frames, num_samples);
+}
+
+static void audio_set_state(bool enabled)
+{
+   audio_ring_store(&audio_callback_enabled, enabled);
+}
+
+/* The core hands the steps in its output straight to
+ * the blipper, so the sound never goes through a buffer
+ * at the native rate only for blipper_push_samples() to
+ * find the steps again. A step at sample t of a run lands
+ * where blipper_push_samples() would have put the t-th
+ * sample of the run. */
+class BlipperSink : public gambatte::SoundSink
+{
+public:
+   virtual void addDelta(unsigned long time, int left, int right)
+   {
+      /* Same cap the sound buffer puts on a run */
+      if (time >= SOUND_BUFF_SIZE)
+         time = SOUND_BUFF_SIZE - 1;
+
+      blipper_add_delta_stereo(resampler_blip, left, right, time + 1);
+   }
+};
+
+static BlipperSink blipper_sink;
+
+/* Same for the polyphase resampler, which takes both
+ * channels in one go */
+class PolyphaseSink : public gambatte::SoundSink
+{
+public:
+   virtual void addDelta(unsigned long time, int left, int right)
+   {
+      if (time >= SOUND_BUFF_SIZE)
+         time = SOUND_BUFF_SIZE - 1;
+
+      polyphase_add_delta(resampler_pp, left, right, time + 1);
+   }
+};
+
+static PolyphaseSink polyphase_sink;
+
+static void blipper_renderaudio(unsigned frames)
+{
+   if (frames > SOUND_BUFF_SIZE)
+      frames = SOUND_BUFF_SIZE;
    if (!frames)
       return;
 
-   blipper_push_samples(resampler_l, samples + 0, frames, 2);
-   blipper_push_samples(resampler_r, samples + 1, frames, 2);
+   blipper_advance(resampler_blip, frames);
 }
 
-static void audio_resampler_deinit(void)
+static void polyphase_renderaudio(unsigned frames)
 {
-   if (resampler_l)
-      blipper_free(resampler_l);
+   if (frames > SOUND_BUFF_SIZE)
+      frames = SOUND_BUFF_SIZE;
 
-   if (resampler_r)
-      blipper_free(resampler_r);
+   polyphase_advance(resampler_pp, frames);
+}
 
-   resampler_l = NULL;
-   resampler_r = NULL;
+/* Stretches of silence (APU or DACs off) come out of
+ * the core flat, and only need resampling once */
+static void cc_renderaudio(gambatte::uint_least32_t *samples, unsigned frames)
+{
+   gambatte::uint_least32_t level;
+
+   if (gb.soundIsFlat(level))
+   {
+      audio_frame_t frame;
+      memcpy(&frame, &level, sizeof(frame));
+      CC_renderflat(frame, frames);
+   }
+   else
+      CC_renderaudio((audio_frame_t*)samples, frames);
+}
+
+/* Resamples a run of the given number of native samples
+ * into the out buffer. With drain unset, resampled audio
+ * only goes to the out buffer once the resampler is half
+ * full. */
+static void audio_renderaudio(gambatte::uint_least32_t *samples,
+      unsigned frames, bool drain)
+{
+   if (use_cc_resampler)
+      cc_renderaudio(samples, frames);
+   else if (use_polyphase_resampler)
+   {
+      polyphase_renderaudio(frames);
+
+      unsigned read_avail = polyphase_read_avail(resampler_pp);
+      if (drain || read_avail >= (POLYPHASE_BUFFER_SIZE >> 1))
+         audio_out_buffer_read_polyphase(read_avail);
+   }
+   else
+   {
+      blipper_renderaudio(frames);
+
+      unsigned read_avail = blipper_read_avail(resampler_blip);
+      if (drain || read_avail >= (BLIP_BUFFER_SIZE >> 1))
+         audio_out_buffer_read_blipper(read_avail);
+   }
+}
+
+static void audio_resampler_deinit(void)
+{
+   blipper_free(resampler_blip);
+   polyphase_free(resampler_pp);
+
+   resampler_blip = NULL;
+   resampler_pp   = NULL;
+   gb.setSoundSink(NULL);
 
    audio_out_buffer_deinit();
 }
 
 static void audio_resampler_init(bool startup)
 {
+   if (use_polyphase_resampler && !use_cc_resampler)
+   {
+      resampler_pp = polyphase_new(polyphase_taps,
+            (unsigned long)(SOUND_SAMPLE_RATE_NATIVE + 0.5),
+            audio_output_rate, POLYPHASE_BUFFER_SIZE);
+
+      /* Only fails out of memory; fall back to sinc, which
+       * changes the sample rate */
+      if (!resampler_pp)
+      {
+         struct retro_system_av_info av_info;
+
+         gambatte_log(RETRO_LOG_WARN,
+               "Polyphase resampler could not be created - using Sinc\n");
+         use_polyphase_resampler = false;
+         retro_get_system_av_info(&av_info);
+         environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &av_info);
+      }
+   }
+
    if (use_cc_resampler)
       CC_init();
-   else
+   else if (!use_polyphase_resampler)
    {
-      resampler_l = blipper_new(32, 0.85, 6.5, 64, BLIP_BUFFER_SIZE, NULL);
-      resampler_r = blipper_new(32, 0.85, 6.5, 64, BLIP_BUFFER_SIZE, NULL);
+      resampler_blip = blipper_new_stereo(32, 0.85, 6.5, 64, BLIP_BUFFER_SIZE, NULL);
 
-      /* It is possible for blipper_new() to fail,
+      /* It is possible for blipper_new_stereo() to fail,
        * must handle errors */
-      if (!resampler_l || !resampler_r)
+      if (!resampler_blip)
       {
          /* Display warning message */
          if (libretro_msg_interface_version >= 1)
@@ -389,6 +588,12 @@ static void audio_resampler_init(bool startup)
       }
    }
 
+   if (use_cc_resampler)
+      gb.setSoundSink(NULL);
+   else if (use_polyphase_resampler)
+      gb.setSoundSink(&polyphase_sink);
+   else
+      gb.setSoundSink(&blipper_sink);
    audio_out_buffer_init();
 }
 
@@ -1259,7 +1464,8 @@ static bool rumble_active                   = false;
 void cartridge_set_rumble(unsigned active)
 {
    if (!rumble.set_rumble_state ||
-       !rumble_level)
+       !rumble_level ||
+       run_ahead_running)
       return;
 
    if (active)
@@ -1348,9 +1554,17 @@ static bool update_option_visibility(void)
          option_display.key = "gambatte_gb_link_mode";
          environ_cb(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
 
+#ifdef HAVE_LOCAL_LINK
+         option_display.key = "gambatte_gb_link_transport";
+         environ_cb(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+#endif
+
          option_display.key = "gambatte_gb_link_network_port";
          environ_cb(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
 
+         option_display.key = "gambatte_gb_link_network_rollback";
+         environ_cb(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+
          for (i = 0; i < 12; i++)
          {
             char key[64] = {0};
@@ -1625,15 +1839,26 @@ static void update_input_state(void)
    libretro_input_state = res;
 }
 
+static void sample_input(void)
+{
+   input_poll_cb();
+   update_input_state();
+   input_sampled = true;
+}
+
 /* gb_input is called multiple times per frame.
  * Determine input state once per frame using
  * update_input_state(), and simply return
- * cached value here */
+ * cached value here. With lazy input, that
+ * happens the first time the game looks at
+ * the joypad, rather than before the frame */
 class SNESInput : public gambatte::InputGetter
 {
    public:
       unsigned operator()()
       {
+         if (!input_sampled)
+            sample_input();
          return libretro_input_state;
       }
 } static gb_input;
@@ -1644,10 +1869,73 @@ enum SerialMode {
    SERIAL_SERVER,
    SERIAL_CLIENT
 };
+enum SerialTransport {
+   TRANSPORT_TCP,
+   TRANSPORT_UNIX,
+   TRANSPORT_SHM
+};
 static NetSerial gb_net_serial;
+static NetRollback gb_net_rollback;
+#ifdef HAVE_LOCAL_LINK
+static ShmSerial gb_shm_serial;
+#endif
 static SerialMode gb_serialMode = SERIAL_NONE;
+static SerialTransport gb_serialTransport = TRANSPORT_TCP;
 static int gb_NetworkPort = 12345;
+static unsigned gb_NetworkRollback = 0;
 static std::string gb_NetworkClientAddr;
+
+static void net_rollback_stop(void)
+{
+   if (!gb_net_rollback.active())
+      return;
+
+   gb_net_rollback.stop();
+   gb.setInputGetter(&gb_input);
+}
+
+#ifndef DUAL_MODE
+static void serial_link_stop(void)
+{
+   gb_net_serial.stop();
+#ifdef HAVE_LOCAL_LINK
+   gb_shm_serial.stop();
+#endif
+   gb.setSerialIO(NULL);
+}
+
+/* Instances on the same host find each other through the
+ * port number, which names the socket file or shared
+ * memory object in place of a TCP port. */
+static void serial_link_start(bool is_server)
+{
+#ifdef HAVE_LOCAL_LINK
+   char name[PATH_MAX_LENGTH];
+
+   if (gb_serialTransport == TRANSPORT_SHM)
+   {
+      gb_net_serial.stop();
+      snprintf(name, sizeof(name), "/gambatte-link-%d", gb_NetworkPort);
+      gb_shm_serial.start(is_server, name);
+      gb.setSerialIO(&gb_shm_serial);
+      return;
+   }
+
+   gb_shm_serial.stop();
+   if (gb_serialTransport == TRANSPORT_UNIX)
+   {
+      const char *tmpdir = getenv("TMPDIR");
+      snprintf(name, sizeof(name), "%s/gambatte-link-%d.sock",
+            tmpdir && *tmpdir ? tmpdir : "/tmp", gb_NetworkPort);
+      gb_net_serial.start(is_server, gb_NetworkPort, gb_NetworkClientAddr, name);
+      gb.setSerialIO(&gb_net_serial);
+      return;
+   }
+#endif
+   gb_net_serial.start(is_server, gb_NetworkPort, gb_NetworkClientAddr);
+   gb.setSerialIO(&gb_net_serial);
+}
+#endif
 #endif
 
 void retro_get_system_info(struct retro_system_info *info)
@@ -1676,8 +1964,7 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
    info->geometry.aspect_ratio = (float)GB_SCREEN_WIDTH / (float)VIDEO_HEIGHT;
 
    info->timing.fps            = VIDEO_REFRESH_RATE;
-   info->timing.sample_rate    = use_cc_resampler ?
-         SOUND_SAMPLE_RATE_CC : SOUND_SAMPLE_RATE_BLIPPER;
+   info->timing.sample_rate    = audio_out_sample_rate();
 }
 
 static void check_system_specs(void)
@@ -1698,9 +1985,6 @@ void retro_init(void)
    // Using uint_least32_t in an audio interface expecting you to cast to short*? :( Weird stuff.
    assert(sizeof(gambatte::uint_least32_t) == sizeof(uint32_t));
    gb.setInputGetter(&gb_input);
-#ifdef DUAL_MODE
-   gb2.setInputGetter(&gb_input);
-#endif
 
 #ifdef _3DS
    video_buf = (gambatte::video_pixel_t*)linearMemAlign(VIDEO_BUFF_SIZE, 128);
@@ -1852,9 +2136,16 @@ void retro_reset()
    /* gb.reset() now preserves battery-backed SRAM and RTC
     * automatically (matching real Game Boy behavior), so the
     * old new[]/memcpy/delete[] dance is no longer needed. */
+#ifdef DUAL_MODE
+   gb2_runner.stop();
+#endif
    gb.reset();
+#ifdef HAVE_NETWORK
+   gb_net_rollback.reset();
+#endif
 #ifdef DUAL_MODE
    gb2.reset();
+   gb2_runner.start(&gb2, &gb2_link_port, &gb_link_port);
 #endif
 
    /* A reset is not a state load, but the same per-session
@@ -1864,10 +2155,10 @@ void retro_reset()
     * pre-reset trails). */
    frame_pacing_reset();
    reset_frame_blending_buffers();
-   if (resampler_l)
-      blipper_reset(resampler_l);
-   if (resampler_r)
-      blipper_reset(resampler_r);
+   if (resampler_blip)
+      blipper_reset(resampler_blip);
+   if (resampler_pp)
+      polyphase_reset(resampler_pp);
    if (use_cc_resampler)
       CC_init();
    audio_out_buffer_pos = 0;
@@ -1918,6 +2209,11 @@ bool retro_unserialize(const void *data, size_t size)
    if (!gb.loadState(data, size))
       return false;
 
+#ifdef HAVE_NETWORK
+   /* Link rollback snapshots belong to the timeline we just left. */
+   gb_net_rollback.reset();
+#endif
+
    /* The audio resampler internal state (blipper integrator,
     * CC accumulator/highpass) and the frame-blending history
     * buffers are NOT part of the savestate. If we leave them
@@ -1925,10 +2221,10 @@ bool retro_unserialize(const void *data, size_t size)
     * ghost-frame bleed across the load boundary -- both visible
     * during runahead/rewind/netplay rollbacks. Reset all of
     * them here so the state load is deterministic. */
-   if (resampler_l)
-      blipper_reset(resampler_l);
-   if (resampler_r)
-      blipper_reset(resampler_r);
+   if (resampler_blip)
+      blipper_reset(resampler_blip);
+   if (resampler_pp)
+      polyphase_reset(resampler_pp);
    if (use_cc_resampler)
       CC_init();
    audio_out_buffer_pos = 0;
@@ -2354,15 +2650,45 @@ static void check_variables(bool startup)
       darkFilterLevel = static_cast<unsigned>(atoi(var.value));
    gb.setDarkFilterLevel(darkFilterLevel);
 
-   bool old_use_cc_resampler = use_cc_resampler;
+   bool old_use_cc_resampler        = use_cc_resampler;
+   bool old_use_polyphase_resampler = use_polyphase_resampler;
+   unsigned old_audio_output_rate   = audio_output_rate;
+   unsigned old_polyphase_taps      = polyphase_taps;
    use_cc_resampler          = false;
+   use_polyphase_resampler   = false;
    var.key                   = "gambatte_audio_resampler";
    var.value                 = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (!strcmp(var.value, "cc"))
+         use_cc_resampler = true;
+      else if (!strcmp(var.value, "polyphase"))
+         use_polyphase_resampler = true;
+   }
+
+   audio_output_rate = 48000;
+   var.key           = "gambatte_audio_output_rate";
+   var.value         = NULL;
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) &&
-       var.value && !strcmp(var.value, "cc"))
-      use_cc_resampler = true;
+       var.value && !strcmp(var.value, "44100"))
+      audio_output_rate = 44100;
 
-   if (!startup && (use_cc_resampler != old_use_cc_resampler))
+   polyphase_taps = 16;
+   var.key        = "gambatte_audio_polyphase_taps";
+   var.value      = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (!strcmp(var.value, "8"))
+         polyphase_taps = 8;
+      else if (!strcmp(var.value, "32"))
+         polyphase_taps = 32;
+   }
+
+   if (!startup && ((use_cc_resampler != old_use_cc_resampler) ||
+         (use_polyphase_resampler != old_use_polyphase_resampler) ||
+         (use_polyphase_resampler &&
+               ((audio_output_rate != old_audio_output_rate) ||
+                (polyphase_taps != old_polyphase_taps)))))
    {
       struct retro_system_av_info av_info;
       audio_resampler_deinit();
@@ -2371,6 +2697,33 @@ static void check_variables(bool startup)
       environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &av_info);
    }
 
+   audio_chunk_samples = 0;
+   var.key             = "gambatte_audio_low_latency";
+   var.value           = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value &&
+       strcmp(var.value, "disabled"))
+   {
+      audio_chunk_samples = atoi(var.value);
+      if (audio_chunk_samples > SOUND_SAMPLES_PER_RUN)
+         audio_chunk_samples = SOUND_SAMPLES_PER_RUN;
+   }
+
+   run_ahead_frames = 0;
+   var.key          = "gambatte_run_ahead";
+   var.value        = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      run_ahead_frames = atoi(var.value);
+
+   lazy_input = false;
+   var.key    = "gambatte_lazy_input";
+   var.value  = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (!strcmp(var.value, "enabled"))
+         lazy_input = true;
+   }
+   gb.setLazyInput(lazy_input);
+
    up_down_allowed = false;
    var.key         = "gambatte_up_down_allowed";
    var.value       = NULL;
@@ -2382,6 +2735,13 @@ static void check_variables(bool startup)
          up_down_allowed = false;
    }
 
+   var.key   = "gambatte_rtc_source";
+   var.value = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      gb.setEmulatedRtc(!strcmp(var.value, "emulated"));
+   else
+      gb.setEmulatedRtc(false);
+
    turbo_period      = TURBO_PERIOD_MIN;
    turbo_pulse_width = TURBO_PULSE_WIDTH_MIN;
    var.key           = "gambatte_turbo_period";
@@ -2437,6 +2797,25 @@ static void check_variables(bool startup)
       gb_NetworkPort=atoi(var.value);
    }
 
+   gb_serialTransport = TRANSPORT_TCP;
+#ifdef HAVE_LOCAL_LINK
+   var.key = "gambatte_gb_link_transport";
+   var.value = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (!strcmp(var.value, "unix"))
+         gb_serialTransport = TRANSPORT_UNIX;
+      else if (!strcmp(var.value, "shm"))
+         gb_serialTransport = TRANSPORT_SHM;
+   }
+#endif
+
+   gb_NetworkRollback = 0;
+   var.key = "gambatte_gb_link_network_rollback";
+   var.value = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      gb_NetworkRollback = atoi(var.value);
+
    unsigned ip_index = 1;
    gb_NetworkClientAddr = "";
 
@@ -2475,22 +2854,30 @@ static void check_variables(bool startup)
       gb_NetworkClientAddr += octet;
    }
 
+#ifdef DUAL_MODE
+   gb.setSerialIO(&gb_link_port);
+#else
    switch(gb_serialMode)
    {
       case SERIAL_SERVER:
-         gb_net_serial.start(true, gb_NetworkPort, gb_NetworkClientAddr);
-         gb.setSerialIO(&gb_net_serial);
+         serial_link_start(true);
          break;
       case SERIAL_CLIENT:
-         gb_net_serial.start(false, gb_NetworkPort, gb_NetworkClientAddr);
-         gb.setSerialIO(&gb_net_serial);
+         serial_link_start(false);
          break;
       default:
-         gb_net_serial.stop();
-         gb.setSerialIO(NULL);
+         serial_link_stop();
          break;
    }
 
+   /* Rollback needs the journal only NetSerial keeps */
+   if (gb_serialMode != SERIAL_NONE && gb_serialTransport != TRANSPORT_SHM
+         && gb_NetworkRollback > 0)
+      gb_net_rollback.start(&gb, &gb_net_serial, gb_NetworkRollback);
+   else
+      net_rollback_stop();
+#endif
+
    /* Show/hide core options */
    update_option_visibility();
 #endif
@@ -2791,8 +3178,10 @@ bool retro_load_game(const struct retro_game_info *info)
    if (gb.load(info->data, info->size, flags) != 0)
       return false;
 #ifdef DUAL_MODE
+   gb2_runner.stop();
    if (gb2.load(info->data, info->size, flags) != 0)
       return false;
+   gb2_runner.start(&gb2, &gb2_link_port, &gb_link_port);
 #endif
 
    rom_path = info->path ? info->path : "";
@@ -2804,6 +3193,18 @@ bool retro_load_game(const struct retro_game_info *info)
    check_variables(true);
    audio_resampler_init(true);
 
+   /* An audio callback can only be set up at load time, so
+    * the option only gets the frontend pulling audio on its
+    * own thread if it was on at load */
+   audio_ring.clear();
+   audio_ring_store(&audio_callback_enabled, 0);
+   if (audio_chunk_samples)
+   {
+      struct retro_audio_callback audio_cb = { audio_callback, audio_set_state };
+      if (environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK, &audio_cb))
+         gambatte_log(RETRO_LOG_INFO, "Using the frontend's audio thread.\n");
+   }
+
    unsigned sramlen       = gb.savedata_size();
    const uint64_t rom     = RETRO_MEMDESC_CONST;
    const uint64_t mainram = RETRO_MEMDESC_SYSTEM_RAM;
@@ -2860,6 +3261,12 @@ bool retro_load_game_special(unsigned, const struct retro_game_info*, size_t) {
 void retro_unload_game()
 {
    rom_loaded = false;
+#ifdef DUAL_MODE
+   gb2_runner.stop();
+#endif
+#ifdef HAVE_NETWORK
+   net_rollback_stop();
+#endif
    /* Clear per-game state so a subsequent retro_load_game with
     * a different ROM doesn't see leftovers (palette autodetect
     * keying off internal_game_name, frame-pacing ratio, cached
@@ -2915,16 +3322,75 @@ size_t retro_get_memory_size(unsigned id)
    return 0;
 }
 
+/* Native run-ahead: the frame the player actually
+ * plays is run without drawing it, then the console
+ * runs ahead from a snapshot with the same input,
+ * drawing only the last frame, and goes back to the
+ * snapshot. What is shown is run_ahead_frames ahead
+ * of what is heard, and the frontend's savestate
+ * format never comes into it. */
+static void run_ahead(void)
+{
+   unsigned i;
+
+   run_ahead_snapshot.resize(gb.snapshotSize());
+   gb.saveSnapshot(&run_ahead_snapshot[0]);
+   run_ahead_running = true;
+   /* The audio of frames that get taken back is never
+    * heard, so it is not synthesized either */
+   gb.setSilent(true);
+
+   for (i = 1; i <= run_ahead_frames; i++)
+   {
+      gambatte::video_pixel_t *buf = (i == run_ahead_frames) ? video_buf : NULL;
+      unsigned samples = SOUND_SAMPLES_PER_RUN;
+
+      while (gb.runFor(buf, VIDEO_PITCH, NULL, 0, samples) == -1)
+         samples = SOUND_SAMPLES_PER_RUN;
+   }
+
+   gb.setSilent(false);
+   run_ahead_running = false;
+   gb.loadSnapshot(&run_ahead_snapshot[0]);
+}
+
+static bool run_ahead_enabled(void)
+{
+#ifdef DUAL_MODE
+   return false;
+#else
+#ifdef HAVE_NETWORK
+   /* Link bytes cannot be taken back */
+   if (gb_serialMode != SERIAL_NONE)
+      return false;
+#endif
+   return run_ahead_frames > 0;
+#endif
+}
+
 void retro_run()
 {
    /* libretro_samples_count and libretro_frames_count are
     * file-scope so they can be reset in retro_load_game,
     * retro_reset, and retro_unserialize. */
 
-   input_poll_cb();
-   update_input_state();
-
    uint64_t expected_frames = libretro_samples_count / SOUND_SAMPLES_PER_FRAME;
+   bool lazy = lazy_input;
+
+#ifdef DUAL_MODE
+   /* The second console is handed its input up front */
+   lazy = false;
+#endif
+#ifdef HAVE_NETWORK
+   /* Rollback snapshots the input with the frame */
+   if (gb_net_rollback.active())
+      lazy = false;
+#endif
+
+   input_sampled = false;
+   if (!lazy || libretro_frames_count < expected_frames)
+      sample_input();
+
    if (libretro_frames_count < expected_frames) // Detect frame dupes.
    {
       video_cb(NULL, VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_PITCH * sizeof(gambatte::video_pixel_t));
@@ -2937,26 +3403,44 @@ void retro_run()
       gambatte::uint_least32_t u32[SOUND_BUFF_SIZE];
       int16_t i16[2 * SOUND_BUFF_SIZE];
    } static sound_buf;
-   unsigned samples = SOUND_SAMPLES_PER_RUN;
+   unsigned chunk   = audio_chunk_samples ? audio_chunk_samples : SOUND_SAMPLES_PER_RUN;
+   unsigned samples = chunk;
+   bool ahead       = run_ahead_enabled();
+   gambatte::video_pixel_t *frame_buf = ahead ? NULL : video_buf;
 
-   while (gb.runFor(video_buf, VIDEO_PITCH, sound_buf.u32, SOUND_BUFF_SIZE, samples) == -1)
+#ifdef DUAL_MODE
+   gb2_runner.beginFrame(libretro_input_state);
+#endif
+#ifdef HAVE_NETWORK
+   if (gb_net_rollback.active())
+      gb_net_rollback.beginFrame(libretro_input_state, chunk);
+#endif
+   while (gb.runFor(frame_buf, VIDEO_PITCH, sound_buf.u32, SOUND_BUFF_SIZE, samples) == -1)
    {
-      if (use_cc_resampler)
-         CC_renderaudio((audio_frame_t*)sound_buf.u32, samples);
-      else
-      {
-         blipper_renderaudio(sound_buf.i16, samples);
-
-         unsigned read_avail = blipper_read_avail(resampler_l);
-         if (read_avail >= (BLIP_BUFFER_SIZE >> 1))
-            audio_out_buffer_read_blipper(read_avail);
-      }
+      audio_renderaudio(sound_buf.u32, samples, audio_chunk_samples != 0);
+      if (audio_chunk_samples)
+         audio_upload_samples();
 
       libretro_samples_count += samples;
-      samples = SOUND_SAMPLES_PER_RUN;
+      samples = chunk;
    }
+
+   /* The frontend is polled once per frame even if the
+    * game never read the joypad, which keeps turbo and
+    * palette switching going */
+   if (!input_sampled)
+      sample_input();
+
+   if (ahead)
+      run_ahead();
+
 #ifdef DUAL_MODE
-   while (gb2.runFor(video_buf + GB_SCREEN_WIDTH, VIDEO_PITCH, sound_buf.u32, samples) == -1) {}
+   gb2_runner.endFrame(video_buf + GB_SCREEN_WIDTH, VIDEO_PITCH);
+#endif
+#ifdef HAVE_NETWORK
+   /* May roll back and redraw this frame with the real link bytes */
+   if (gb_net_rollback.active())
+      gb_net_rollback.endFrame(video_buf, VIDEO_PITCH);
 #endif
 
    /* Perform interframe blending, if required */
@@ -2965,15 +3449,7 @@ void retro_run()
 
    video_cb(video_buf, VIDEO_WIDTH, VIDEO_HEIGHT, VIDEO_PITCH * sizeof(gambatte::video_pixel_t));
 
-   if (use_cc_resampler)
-      CC_renderaudio((audio_frame_t*)sound_buf.u32, samples);
-   else
-   {
-      blipper_renderaudio(sound_buf.i16, samples);
-
-      unsigned read_avail = blipper_read_avail(resampler_l);
-      audio_out_buffer_read_blipper(read_avail);
-   }
+   audio_renderaudio(sound_buf.u32, samples, true);
    libretro_samples_count += samples;
    audio_upload_samples();
 
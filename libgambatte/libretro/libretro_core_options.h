@@ -624,12 +624,13 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       "gambatte_audio_resampler",
       "Audio Resampler",
       NULL,
-      "Specify which algorithm to use when resampling generated audio (the Game Boy audio rate is limited only by its CPU write speed, such that 'native' frequencies are impractical on modern sound devices and must be downsampled). 'Sinc' produces the highest quality. 'Cosine' improves performance on low-end hardware.",
+      "Specify which algorithm to use when resampling generated audio (the Game Boy audio rate is limited only by its CPU write speed, such that 'native' frequencies are impractical on modern sound devices and must be downsampled). 'Sinc' produces the highest quality. 'Cosine' improves performance on low-end hardware. 'Polyphase' outputs straight at the rate of the sound device.",
       NULL,
       NULL,
       {
-         { "sinc", "Sinc" },
-         { "cc",   "Cosine" },
+         { "sinc",      "Sinc" },
+         { "cc",        "Cosine" },
+         { "polyphase", "Polyphase" },
          { NULL, NULL },
       },
 #if (defined(PS2) || defined(PSP) || defined(VITA) || defined(_3DS) || defined(DINGUX))
@@ -638,6 +639,51 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       "sinc"
 #endif
    },
+   {
+      "gambatte_audio_output_rate",
+      "Polyphase Output Rate",
+      NULL,
+      "Sample rate the 'Polyphase' resampler outputs at. Setting this to the rate of the sound device saves the frontend from resampling the audio a second time.",
+      NULL,
+      NULL,
+      {
+         { "48000", "48000 Hz" },
+         { "44100", "44100 Hz" },
+         { NULL, NULL },
+      },
+      "48000"
+   },
+   {
+      "gambatte_audio_polyphase_taps",
+      "Polyphase Quality",
+      NULL,
+      "Length of the filter the 'Polyphase' resampler draws each change in the sound with. Longer filters cut off more sharply above the audible range, for more work per change.",
+      NULL,
+      NULL,
+      {
+         { "8",  "Low (8 Taps)" },
+         { "16", "Medium (16 Taps)" },
+         { "32", "High (32 Taps)" },
+         { NULL, NULL },
+      },
+      "16"
+   },
+   {
+      "gambatte_audio_low_latency",
+      "Low-Latency Audio",
+      NULL,
+      "Run the emulation in shorter chunks and hand the audio of each chunk to the frontend's audio thread as soon as it is resampled, instead of once a frame. Only has an effect with frontends that pull audio on their own thread (an audio callback), and only if this is on when content is loaded; otherwise a frame's audio reaches the frontend within the same run of the core either way.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "2064",     "1 ms Chunks" },
+         { "1032",     "0.5 ms Chunks" },
+         { "516",      "0.25 ms Chunks" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
    {
       "gambatte_gb_hwmode",
       "Emulated Hardware (Restart Required)",
@@ -668,6 +714,20 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "enabled"
    },
+   {
+      "gambatte_rtc_source",
+      "Cartridge Clock",
+      NULL,
+      "Time source of the real-time clock in MBC3 and HuC3 cartridges. 'Host Time' follows the system clock. 'Emulated Time' starts from the system clock when content is loaded and then advances with the emulated console, so fast-forward, slow-motion and pause affect in-game time the same way they affect everything else, and savestates restore it.",
+      NULL,
+      NULL,
+      {
+         { "host",     "Host Time" },
+         { "emulated", "Emulated Time" },
+         { NULL, NULL },
+      },
+      "host"
+   },
    {
       "gambatte_up_down_allowed",
       "Allow Opposing Directions",
@@ -682,6 +742,37 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "disabled"
    },
+   {
+      "gambatte_run_ahead",
+      "Internal Run-Ahead",
+      NULL,
+      "Show the frame that is this many frames ahead of the emulated console, using the same input, to hide that many frames of the game's own input lag. Much cheaper than the frontend's run-ahead, which should be left off while this is used. Too many frames make the game skip. Not used with GameLink.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "1",        "1 Frame" },
+         { "2",        "2 Frames" },
+         { "3",        "3 Frames" },
+         { "4",        "4 Frames" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "gambatte_lazy_input",
+      "Lazy Input Polling",
+      NULL,
+      "Poll input when the game first reads the joypad in a frame instead of before the frame starts. Input is still taken once a frame, so the latency saved is the time from the start of the frame to the game's first joypad read. Works best with the frontend's late input polling. Not used with GameLink rollback.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
    {
       "gambatte_turbo_period",
       "Turbo Button Period",
@@ -864,6 +955,23 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "Not Connected"
    },
+#ifdef HAVE_LOCAL_LINK
+   {
+      "gambatte_gb_link_transport",
+      "Game Link Transport",
+      "Transport",
+      "Specify how linked instances exchange data. 'TCP' works across machines. 'Unix Socket' and 'Shared Memory' only link instances on the same host, which find each other through the 'Network Link Port' setting. 'Shared Memory' passes bytes without system calls and does not use 'Network Link Rollback'.",
+      NULL,
+      "gb_link",
+      {
+         { "tcp",  "TCP" },
+         { "unix", "Unix Socket" },
+         { "shm",  "Shared Memory" },
+         { NULL, NULL },
+      },
+      "tcp"
+   },
+#endif
    {
       "gambatte_gb_link_network_port",
       "Network Link Port",
@@ -897,6 +1005,24 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "56400"
    },
+   {
+      "gambatte_gb_link_network_rollback",
+      "Network Link Rollback",
+      "Rollback",
+      "Hide network latency by guessing the byte the remote Game Boy will send instead of waiting for it. When a guess turns out wrong, the game is rolled back and replayed with the real byte, up to the specified number of frames; a connection slower than that still stalls. Not compatible with frontend Run-Ahead.",
+      NULL,
+      "gb_link",
+      {
+         { "disabled", NULL },
+         { "2",        "2 Frames" },
+         { "4",        "4 Frames" },
+         { "6",        "6 Frames" },
+         { "8",        "8 Frames" },
+         { "12",       "12 Frames" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
    {
       "gambatte_gb_link_network_server_ip_1",
       "Network Link Server Address Pt. 01: x__.___.___.___",
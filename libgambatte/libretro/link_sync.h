@@ -0,0 +1,166 @@
+#ifndef _LINK_SYNC_H
+#define _LINK_SYNC_H
+
+// Minimal threading helpers shared by the link cable transports: C++98 has no
+// atomics or threads, so these wrap the compiler builtins and pthreads/Win32.
+
+#include <string.h>
+#ifdef _WIN32
+#include <winsock2.h> /* before windows.h, which would pull in winsock 1 */
+#include <windows.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+static inline unsigned link_load(const unsigned* p)
+{
+	unsigned const v = *static_cast<const volatile unsigned*>(p);
+	_ReadWriteBarrier();
+	return v;
+}
+static inline void link_store(unsigned* p, unsigned v)
+{
+	_ReadWriteBarrier();
+	*static_cast<volatile unsigned*>(p) = v;
+}
+static inline bool link_cas(unsigned* p, unsigned expected, unsigned desired)
+{
+	return static_cast<unsigned>(InterlockedCompareExchange(
+			reinterpret_cast<volatile LONG*>(p), desired, expected)) == expected;
+}
+#else
+static inline unsigned link_load(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static inline void link_store(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+static inline bool link_cas(unsigned* p, unsigned expected, unsigned desired)
+{
+	return __sync_bool_compare_and_swap(p, expected, desired);
+}
+#endif
+
+// Yield first so a peer that is about to answer gets the core quickly,
+// then back off to short sleeps so an idle wait doesn't burn a whole core.
+static inline void link_relax(unsigned& spins)
+{
+	++spins;
+#ifdef _WIN32
+	if (spins < 64)
+		SwitchToThread();
+	else
+		Sleep(spins < 1024 ? 0 : 1);
+#else
+	if (spins < 64)
+		sched_yield();
+	else
+		usleep(spins < 1024 ? 50 : 1000);
+#endif
+}
+
+// Lock-free single-producer single-consumer ring of link messages.
+// Exactly one thread pushes and exactly one thread pops.
+template<unsigned size>
+class LinkChannel
+{
+	public:
+		LinkChannel() { clear(); }
+
+		// Only while neither end is in use.
+		void clear()
+		{
+			head_ = 0;
+			tail_ = 0;
+			memset(msg_, 0, sizeof msg_);
+		}
+
+		bool push(unsigned msg)
+		{
+			unsigned const head = head_;
+			if (head - link_load(&tail_) == size)
+				return false;
+
+			msg_[head % size] = msg;
+			link_store(&head_, head + 1);
+			return true;
+		}
+
+		// Consumer side only.
+		bool empty() const { return link_load(&head_) == tail_; }
+
+		bool pop(unsigned& msg)
+		{
+			unsigned const tail = tail_;
+			if (link_load(&head_) == tail)
+				return false;
+
+			msg = msg_[tail % size];
+			link_store(&tail_, tail + 1);
+			return true;
+		}
+
+	private:
+		unsigned head_;
+		unsigned tail_;
+		unsigned msg_[size];
+};
+
+class LinkThread
+{
+	public:
+		LinkThread() : running_(false) {}
+
+		bool start(void (*fn)(void*), void* arg)
+		{
+			fn_ = fn;
+			arg_ = arg;
+#ifdef _WIN32
+			thread_ = CreateThread(NULL, 0, entry, this, 0, NULL);
+			running_ = thread_ != NULL;
+#else
+			running_ = pthread_create(&thread_, NULL, entry, this) == 0;
+#endif
+			return running_;
+		}
+
+		void join()
+		{
+			if (!running_)
+				return;
+#ifdef _WIN32
+			WaitForSingleObject(thread_, INFINITE);
+			CloseHandle(thread_);
+#else
+			pthread_join(thread_, NULL);
+#endif
+			running_ = false;
+		}
+
+		bool running() const { return running_; }
+
+	private:
+#ifdef _WIN32
+		static DWORD WINAPI entry(void* self)
+#else
+		static void* entry(void* self)
+#endif
+		{
+			LinkThread* const t = static_cast<LinkThread*>(self);
+			t->fn_(t->arg_);
+			return 0;
+		}
+
+		void (*fn_)(void*);
+		void* arg_;
+		bool running_;
+#ifdef _WIN32
+		HANDLE thread_;
+#else
+		pthread_t thread_;
+#endif
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "net_rollback.h"
+#include "libretro.h"
+#include "gambatte_log.h"
+
+NetRollback::NetRollback()
+: gb_(0)
+, serial_(0)
+, window_(0)
+, frame_(0)
+, saved_(0)
+, input_(0)
+, stateSize_(0)
+{
+}
+
+void NetRollback::start(gambatte::GB* gb, NetSerial* serial, unsigned window)
+{
+	stop();
+
+	if (window < 2)
+		window = 2;
+	if (window > max_window)
+		window = max_window;
+
+	gb_ = gb;
+	serial_ = serial;
+	window_ = window;
+	serial_->setSpeculative(true);
+	gb_->setInputGetter(this);
+	reset();
+
+	gambatte_log(RETRO_LOG_INFO, "GameLink rollback enabled, up to %u frames.\n", window_);
+}
+
+// The caller hands the console its own input getter back.
+void NetRollback::stop()
+{
+	if (!gb_)
+		return;
+
+	serial_->setSpeculative(false);
+	gb_ = 0;
+	serial_ = 0;
+}
+
+// For when the console was loaded, reset or had a state loaded behind our
+// back: the snapshots and the journal describe a timeline that is gone.
+void NetRollback::reset()
+{
+	if (!gb_)
+		return;
+
+	frame_ = 0;
+	saved_ = 0;
+	stateSize_ = gb_->stateSize();
+	serial_->clearJournal();
+}
+
+void NetRollback::beginFrame(unsigned input, unsigned samplesPerRun)
+{
+	if (samplesPerRun > max_samples_per_run)
+		samplesPerRun = max_samples_per_run;
+
+	++frame_;
+	save(frame_, input, samplesPerRun);
+	if (saved_ < window_)
+		++saved_;
+
+	serial_->beginFrame(frame_);
+	input_ = input;
+}
+
+void NetRollback::endFrame(gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch)
+{
+	// Once the window is full, the next beginFrame() overwrites the oldest
+	// snapshot, so everything sent in that frame has to be settled first.
+	// This is the only place emulation ever waits for the network.
+	bool const full = saved_ == window_;
+	unsigned const keep = frame_ + 2 - window_;
+	unsigned frame;
+
+	for (;;) {
+		if (serial_->mispredicted(frame))
+			rollback(frame, videoBuf, pitch);
+		else if (!full || serial_->settled(keep))
+			break;
+		else
+			serial_->awaitReply();
+	}
+
+	if (full)
+		serial_->forget(keep);
+}
+
+unsigned NetRollback::operator()()
+{
+	return input_;
+}
+
+void NetRollback::save(unsigned frame, unsigned input, unsigned samplesPerRun)
+{
+	Snapshot& s = snapshots_[frame % window_];
+
+	s.frame = frame;
+	s.input = input;
+	s.samplesPerRun = samplesPerRun;
+	s.state.resize(stateSize_);
+	gb_->saveState(&s.state[0]);
+}
+
+void NetRollback::runFrame(unsigned samplesPerRun, gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch)
+{
+	unsigned samples = samplesPerRun;
+
+	while (gb_->runFor(videoBuf, pitch, sound_, sound_buf_size, samples) == -1)
+		samples = samplesPerRun;
+}
+
+void NetRollback::rollback(unsigned frame, gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch)
+{
+	if (frame_ - frame >= saved_) {
+		gambatte_log(RETRO_LOG_WARN, "GameLink byte for frame %u arrived too late to roll back.\n", frame);
+		return;
+	}
+
+	Snapshot const& s = snapshots_[frame % window_];
+	if (!gb_->loadState(&s.state[0], s.state.size())) {
+		gambatte_log(RETRO_LOG_ERROR, "GameLink rollback could not restore frame %u.\n", frame);
+		return;
+	}
+
+	serial_->rewind(frame);
+	// Sound of the replayed frames is already out, so it is not made
+	// again, nor handed to the sound sink a second time.
+	bool const silent = gb_->isSilent();
+	gb_->setSilent(true);
+	for (unsigned f = frame;; ++f) {
+		unsigned const input = snapshots_[f % window_].input;
+		unsigned const samplesPerRun = snapshots_[f % window_].samplesPerRun;
+
+		if (f != frame)
+			save(f, input, samplesPerRun);
+		serial_->beginFrame(f);
+		input_ = input;
+
+		// Only the frame on screen is worth redrawing.
+		if (f == frame_) {
+			runFrame(samplesPerRun, videoBuf, pitch);
+			break;
+		}
+		runFrame(samplesPerRun, 0, 0);
+	}
+	gb_->setSilent(silent);
+}
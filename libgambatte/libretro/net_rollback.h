@@ -0,0 +1,62 @@
+#ifndef _NET_ROLLBACK_H
+#define _NET_ROLLBACK_H
+
+#include <gambatte.h>
+#include <cstddef>
+#include <vector>
+#include "net_serial.h"
+
+// Hides network latency on the link cable. NetSerial is put in speculative
+// mode so the console never waits for the peer's byte; a snapshot is kept for
+// each of the last few frames, and when a guessed byte turns out wrong the
+// console is put back to the frame of the guess and run forward again with
+// the real bytes. Only the last of the replayed frames is drawn.
+class NetRollback : public gambatte::InputGetter
+{
+	public:
+		enum { max_window = 16 };
+
+		NetRollback();
+
+		void start(gambatte::GB* gb, NetSerial* serial, unsigned window);
+		void stop();
+		void reset();
+		bool active() const { return gb_ != 0; }
+
+		// samplesPerRun is what the frontend passes runFor() for this frame,
+		// at most max_samples_per_run.
+		void beginFrame(unsigned input, unsigned samplesPerRun);
+		void endFrame(gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch);
+
+		virtual unsigned operator()();
+
+	private:
+		enum { max_samples_per_run = 2064, sound_buf_size = max_samples_per_run + 2064 };
+
+		// runFor() returns at the end of every frame whatever the chunk size,
+		// but on test ROMs that read the sound registers at odd times the
+		// state drifted apart between chunk sizes, so a frame is replayed in
+		// the chunks it was first run in.
+		struct Snapshot {
+			unsigned frame;
+			unsigned input;
+			unsigned samplesPerRun;
+			std::vector<char> state;
+		};
+
+		void save(unsigned frame, unsigned input, unsigned samplesPerRun);
+		void runFrame(unsigned samplesPerRun, gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch);
+		void rollback(unsigned frame, gambatte::video_pixel_t* videoBuf, std::ptrdiff_t pitch);
+
+		gambatte::GB* gb_;
+		NetSerial* serial_;
+		unsigned window_;
+		unsigned frame_;
+		unsigned saved_;
+		unsigned input_;
+		std::size_t stateSize_;
+		Snapshot snapshots_[max_window];
+		gambatte::uint_least32_t sound_[sound_buf_size];
+};
+
+#endif
@@ -6,25 +6,52 @@
 #include <unistd.h>
 #include <errno.h>
 #include <sys/types.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #else
 #include <sys/socket.h>
-#include <sys/ioctl.h>
+#include <sys/select.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <netdb.h>
 #endif
+#ifdef HAVE_LOCAL_LINK
+#include <sys/un.h>
+#endif
+
+// Frames on the wire are two bytes: a request is [data, fastCgb], a reply is
+// [data, reply_marker]. Inside the process a frame travels as data | second << 8.
+enum { reply_marker = 128 };
+
+// How many times the I/O thread looks for work after the last frame before
+// it goes to sleep in select(). A poll is a zero-timeout select() and a
+// yield; this many bridge gaps of a millisecond or so between frames.
+enum { idle_polls = 2000 };
 
 NetSerial::NetSerial()
 : is_stopped_(true)
 , is_server_(false)
 , port_(12345)
 , hostname_()
+, socketPath_()
 , server_fd_(-1)
 , sockfd_(-1)
+, wakeRead_(-1)
+, wakeWrite_(-1)
 , lastConnectAttempt_(0)
+, quit_(0)
+, connected_(0)
+, sleeping_(0)
+, stale_(0)
+, partial_(-1)
+, speculative_(false)
+, nextId_(0)
 {
+	clearJournal();
 }
 
 NetSerial::~NetSerial()
@@ -32,24 +59,56 @@ NetSerial::~NetSerial()
 	stop();
 }
 
-bool NetSerial::start(bool is_server, int port, const std::string& hostname)
+bool NetSerial::start(bool is_server, int port, const std::string& hostname,
+		const std::string& socketPath)
 {
 	stop();
 
-	gambatte_log(RETRO_LOG_INFO, "Starting GameLink network %s on %s:%d\n",
-			is_server ? "server" : "client", hostname.c_str(), port);
+	if (socketPath.empty()) {
+		gambatte_log(RETRO_LOG_INFO, "Starting GameLink network %s on %s:%d\n",
+				is_server ? "server" : "client", hostname.c_str(), port);
+	} else {
+		gambatte_log(RETRO_LOG_INFO, "Starting GameLink local %s on %s\n",
+				is_server ? "server" : "client", socketPath.c_str());
+	}
 	is_server_ = is_server;
 	port_ = port;
 	hostname_ = hostname;
+	socketPath_ = socketPath;
 	is_stopped_ = false;
 
-	return checkAndRestoreConnection(false);
+	quit_ = 0;
+	connected_ = 0;
+	sleeping_ = 0;
+	partial_ = -1;
+	rx_.clear();
+	tx_.clear();
+	clearJournal();
+	stale_ = 0;
+	lastConnectAttempt_ = 0;
+
+	if (!openWake()) {
+		gambatte_log(RETRO_LOG_ERROR, "Could not create GameLink wake-up channel: %s\n", strerror(errno));
+		is_stopped_ = true;
+		return false;
+	}
+	if (!thread_.start(ioEntry, this)) {
+		gambatte_log(RETRO_LOG_ERROR, "Could not start GameLink network thread.\n");
+		closeWake();
+		is_stopped_ = true;
+		return false;
+	}
+	return true;
 }
 void NetSerial::stop()
 {
 	if (!is_stopped_) {
 		gambatte_log(RETRO_LOG_INFO, "Stopping GameLink network\n");
 		is_stopped_ = true;
+		link_store(&quit_, 1);
+		wake();
+		thread_.join();
+		closeWake();
 		if (sockfd_ >= 0) {
 			close(sockfd_);
 			sockfd_ = -1;
@@ -57,6 +116,10 @@ void NetSerial::stop()
 		if (server_fd_ >= 0) {
 			close(server_fd_);
 			server_fd_ = -1;
+#ifdef HAVE_LOCAL_LINK
+			if (!socketPath_.empty())
+				unlink(socketPath_.c_str());
+#endif
 		}
 	}
 }
@@ -67,13 +130,13 @@ bool NetSerial::checkAndRestoreConnection(bool throttle)
 		return false;
 	}
 	if (sockfd_ < 0 && throttle) {
-		clock_t now = clock();
+		time_t now = time(NULL);
 		// Only attempt to establish the connection every 5 seconds
-		if (((now - lastConnectAttempt_) / CLOCKS_PER_SEC) < 5) {
+		if (now - lastConnectAttempt_ < 5) {
 			return false;
 		}
 	}
-	lastConnectAttempt_ = clock();
+	lastConnectAttempt_ = time(NULL);
 	if (is_server_) {
 		if (!startServerSocket()) {
 			return false;
@@ -92,6 +155,10 @@ bool NetSerial::startServerSocket()
 {
 	struct sockaddr_in server_addr;
 
+#ifdef HAVE_LOCAL_LINK
+	if (!socketPath_.empty())
+		return startLocalServerSocket();
+#endif
 	if (server_fd_ < 0) {
 		memset((char *)&server_addr, '\0', sizeof(server_addr));
 		server_addr.sin_family = AF_INET;
@@ -148,6 +215,8 @@ bool NetSerial::acceptClient()
 			gambatte_log(RETRO_LOG_ERROR, "Error on accept: %s\n", strerror(errno));
 			return false;
 		}
+		if (socketPath_.empty())
+			setNoDelay(sockfd_);
 		gambatte_log(RETRO_LOG_INFO, "GameLink network server connected to client!\n");
 	}
 	return true;
@@ -156,6 +225,10 @@ bool NetSerial::startClientSocket()
 {
 	struct sockaddr_in server_addr;
 
+#ifdef HAVE_LOCAL_LINK
+	if (!socketPath_.empty())
+		return startLocalClientSocket();
+#endif
 	if (sockfd_ < 0) {
 		memset((char *)&server_addr, '\0', sizeof(server_addr));
 		server_addr.sin_family = AF_INET;
@@ -181,114 +254,626 @@ bool NetSerial::startClientSocket()
 			return false;
 		}
 		sockfd_ = fd;
+		setNoDelay(sockfd_);
 		gambatte_log(RETRO_LOG_INFO, "GameLink network client connected to server!\n");
 	}
 	return true;
 }
 
-unsigned char NetSerial::send(unsigned char data, bool fastCgb)
+#ifdef HAVE_LOCAL_LINK
+// Unix domain sockets for instances on the same host: same frames, same I/O
+// thread, but no TCP/IP stack in between.
+static bool localAddress(const std::string& path, struct sockaddr_un& addr)
+{
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		gambatte_log(RETRO_LOG_ERROR, "Socket path too long: %s\n", path.c_str());
+		return false;
+	}
+	memcpy(addr.sun_path, path.c_str(), path.size());
+	return true;
+}
+
+bool NetSerial::startLocalServerSocket()
 {
-	unsigned char buffer[2];
+	struct sockaddr_un addr;
 
-	if (is_stopped_) {
-		return 0xFF;
+	if (server_fd_ < 0) {
+		if (!localAddress(socketPath_, addr)) {
+			return false;
+		}
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) {
+			gambatte_log(RETRO_LOG_ERROR, "Error opening socket: %s\n", strerror(errno));
+			return false;
+		}
+
+		// A socket file left behind by a server that died would fail the bind.
+		unlink(socketPath_.c_str());
+		if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+			gambatte_log(RETRO_LOG_ERROR, "Error on binding: %s\n", strerror(errno));
+			close(fd);
+			return false;
+		}
+
+		if (listen(fd, 1) < 0) {
+			gambatte_log(RETRO_LOG_ERROR, "Error listening: %s\n", strerror(errno));
+			close(fd);
+			unlink(socketPath_.c_str());
+			return false;
+		}
+		server_fd_ = fd;
+		gambatte_log(RETRO_LOG_INFO, "GameLink local server started!\n");
 	}
+
+	return true;
+}
+
+bool NetSerial::startLocalClientSocket()
+{
+	struct sockaddr_un addr;
+
 	if (sockfd_ < 0) {
-		if (!checkAndRestoreConnection(true)) {
-			return 0xFF;
+		if (!localAddress(socketPath_, addr)) {
+			return false;
 		}
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) {
+			gambatte_log(RETRO_LOG_ERROR, "Error opening socket: %s\n", strerror(errno));
+			return false;
+		}
+
+		if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+			gambatte_log(RETRO_LOG_ERROR, "Error connecting to server: %s\n", strerror(errno));
+			close(fd);
+			return false;
+		}
+		sockfd_ = fd;
+		gambatte_log(RETRO_LOG_INFO, "GameLink local client connected to server!\n");
 	}
+	return true;
+}
+#endif
 
-	buffer[0] = data;
-	buffer[1] = fastCgb;
+void NetSerial::setNoDelay(int fd)
+{
+	// Every frame is a couple of bytes the peer is waiting on; don't let
+	// Nagle's algorithm hold them back.
+	int one = 1;
+	if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*) &one, sizeof(one)) < 0) {
+		gambatte_log(RETRO_LOG_WARN, "Could not set TCP_NODELAY: %s\n", strerror(errno));
+	}
+}
+
+void NetSerial::closeConnection()
+{
+	close(sockfd_);
+	sockfd_ = -1;
+	partial_ = -1;
+	link_store(&connected_, 0);
+}
+
+// A pipe on POSIX; winsock can only select() on sockets, so Windows uses a
+// loopback UDP socket connected to itself. Both ends are non-blocking: a full
+// pipe already holds a pending wake-up.
+bool NetSerial::openWake()
+{
 #ifdef _WIN32
-   if (::send(sockfd_, (char*) buffer, 2, 0) <= 0)
+	struct sockaddr_in addr;
+	int addrlen = sizeof(addr);
+	u_long nonblocking = 1;
+
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		return false;
+	memset((char *)&addr, '\0', sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = 0;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+			|| getsockname(fd, (struct sockaddr *)&addr, &addrlen) < 0
+			|| connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+			|| ioctlsocket(fd, FIONBIO, &nonblocking) != 0) {
+		close(fd);
+		return false;
+	}
+	wakeRead_ = fd;
+	wakeWrite_ = fd;
 #else
-	if (write(sockfd_, buffer, 2) <= 0)
+	int fds[2];
+	if (pipe(fds) < 0)
+		return false;
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+	fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+	wakeRead_ = fds[0];
+	wakeWrite_ = fds[1];
 #endif
-   {
-		gambatte_log(RETRO_LOG_ERROR, "Error writing to socket: %s\n", strerror(errno));
-		close(sockfd_);
-		sockfd_ = -1;
-		return 0xFF;
-	}
+	return true;
+}
 
+void NetSerial::closeWake()
+{
+	if (wakeWrite_ >= 0 && wakeWrite_ != wakeRead_)
+		close(wakeWrite_);
+	if (wakeRead_ >= 0)
+		close(wakeRead_);
+	wakeRead_ = -1;
+	wakeWrite_ = -1;
+}
+
+void NetSerial::wake()
+{
+	char const b = 0;
 #ifdef _WIN32
-	if (recv(sockfd_, (char*) buffer, 2, 0) <= 0) 
+	::send(wakeWrite_, &b, 1, 0);
 #else
-   if (read(sockfd_, buffer, 2) <= 0) 
-#endif
-   {
-		gambatte_log(RETRO_LOG_ERROR, "Error reading from socket: %s\n", strerror(errno));
-		close(sockfd_);
-		sockfd_ = -1;
-		return 0xFF;
+	if (write(wakeWrite_, &b, 1) < 0) {
+		// EAGAIN: a wake-up is already pending.
 	}
+#endif
+}
+
+// Emulation thread: queue a frame for the I/O thread. If the thread has gone
+// to sleep in select(), which it does once the link has been idle for
+// idle_polls, this costs one write() to the wake-up pipe; an isolated transfer
+// pays it, frames following closely on another do not.
+bool NetSerial::queue(unsigned frame)
+{
+	if (!tx_.push(frame))
+		return false;
+	if (link_cas(&sleeping_, 1, 0))
+		wake();
+	return true;
+}
 
-	return buffer[0];
+void NetSerial::ioEntry(void* self)
+{
+	static_cast<NetSerial*>(self)->ioRun();
 }
 
-bool NetSerial::check(unsigned char out, unsigned char& in, bool& fastCgb)
+// The I/O thread owns the sockets. It connects, writes everything queued by
+// the emulation thread in one go and splits whatever arrives into frames.
+void NetSerial::ioRun()
 {
-	unsigned char buffer[2];
+	unsigned char buffer[2 * tx_frames];
+	unsigned frame;
+
+	while (!link_load(&quit_)) {
+		if (sockfd_ < 0) {
+			// Frames queued for a connection that is gone are meaningless.
+			while (tx_.pop(frame)) {}
+			// Polling a listening socket for a client is cheap, so only
+			// connection and bind attempts are throttled.
+			bool const throttle = lastConnectAttempt_ != 0 && (!is_server_ || server_fd_ < 0);
+			if (!checkAndRestoreConnection(throttle)) {
 #ifdef _WIN32
-	u_long bytes_avail = 0;
+				Sleep(10);
 #else
-	int bytes_avail = 0;
+				usleep(10000);
 #endif
-	if (is_stopped_) {
-		return false;
-	}
-	if (sockfd_ < 0) {
-		if (!checkAndRestoreConnection(true)) {
-			return false;
+				continue;
+			}
+			link_store(&connected_, 1);
 		}
-	}
+
+		std::size_t len = 0;
+		while (len < sizeof(buffer) && tx_.pop(frame)) {
+			buffer[len++] = frame & 0xFF;
+			buffer[len++] = frame >> 8;
+		}
+		for (std::size_t pos = 0; pos < len;) {
 #ifdef _WIN32
-   if (ioctlsocket(sockfd_, FIONREAD, &bytes_avail) < 0)
+			int const n = ::send(sockfd_, (char*) buffer + pos, len - pos, 0);
 #else
-	if (ioctl(sockfd_, FIONREAD, &bytes_avail) < 0)
+			int const n = write(sockfd_, buffer + pos, len - pos);
 #endif
-   {
-		gambatte_log(RETRO_LOG_ERROR, "IOCTL Failed: %s\n", strerror(errno));
-		return false;
-	}
+			if (n <= 0) {
+				gambatte_log(RETRO_LOG_ERROR, "Error writing to socket: %s\n", strerror(errno));
+				closeConnection();
+				break;
+			}
+			pos += n;
+		}
+		if (sockfd_ < 0)
+			continue;
 
-	// No data available yet
-	if (bytes_avail < 2) {
-		return false;
-	}
+		// Transfers come in bursts: a game that has its byte usually clocks
+		// the next one soon after. Stay awake polling for a while, so that
+		// only the first frame of a burst has to wake this thread up.
+		fd_set rfds;
+		bool readable = false;
+		for (unsigned polls = 0; polls < idle_polls && !readable && tx_.empty(); ++polls) {
+			struct timeval tv;
+			tv.tv_sec = 0;
+			tv.tv_usec = 0;
+			FD_ZERO(&rfds);
+			FD_SET(sockfd_, &rfds);
+			readable = select(sockfd_ + 1, &rfds, NULL, NULL, &tv) > 0;
+			if (!readable) {
+				// Let the emulation thread run on a busy or single core.
+#ifdef _WIN32
+				SwitchToThread();
+#else
+				sched_yield();
+#endif
+			}
+		}
 
+		if (!readable) {
+			// Announce the sleep before the last look at the queue; both
+			// sides go through a full barrier, so a frame pushed after that
+			// look finds sleeping_ set and writes a wake-up byte.
+			link_cas(&sleeping_, 0, 1);
+			if (!tx_.empty()) {
+				link_cas(&sleeping_, 1, 0);
+				continue;
+			}
+
+			FD_ZERO(&rfds);
+			FD_SET(sockfd_, &rfds);
+			FD_SET(wakeRead_, &rfds);
+			int const ready = select((sockfd_ > wakeRead_ ? sockfd_ : wakeRead_) + 1,
+					&rfds, NULL, NULL, NULL);
+			link_store(&sleeping_, 0);
+			if (ready <= 0)
+				continue;
+			if (FD_ISSET(wakeRead_, &rfds)) {
 #ifdef _WIN32
-	if (recv(sockfd_, (char*) buffer, 2, 0) <= 0) 
+				while (recv(wakeRead_, (char*) buffer, sizeof(buffer), 0) > 0) {}
 #else
-   if (read(sockfd_, buffer, 2) <= 0) 
+				while (read(wakeRead_, buffer, sizeof(buffer)) > 0) {}
 #endif
-   {
-		gambatte_log(RETRO_LOG_ERROR, "Error reading from socket: %s\n", strerror(errno));
-		close(sockfd_);
-		sockfd_ = -1;
+			}
+			if (!FD_ISSET(sockfd_, &rfds))
+				continue;
+		}
+
+#ifdef _WIN32
+		int const n = recv(sockfd_, (char*) buffer, sizeof(buffer), 0);
+#else
+		int const n = read(sockfd_, buffer, sizeof(buffer));
+#endif
+		if (n <= 0) {
+			if (n == 0)
+				gambatte_log(RETRO_LOG_INFO, "GameLink peer closed the connection\n");
+			else
+				gambatte_log(RETRO_LOG_ERROR, "Error reading from socket: %s\n", strerror(errno));
+			closeConnection();
+			continue;
+		}
+		for (int i = 0; i < n; ++i) {
+			if (partial_ < 0) {
+				partial_ = buffer[i];
+				continue;
+			}
+			frame = partial_ | buffer[i] << 8;
+			partial_ = -1;
+
+			unsigned spins = 0;
+			while (!rx_.push(frame) && !link_load(&quit_))
+				link_relax(spins);
+		}
+	}
+}
+
+// Emulation thread side: these work on the lock-free queues. They enter the
+// kernel in two cases: queue() waking an idle I/O thread, and send() backing
+// off through link_relax (sched_yield, then usleep) while the reply is slow.
+unsigned char NetSerial::send(unsigned char data, bool fastCgb)
+{
+	if (speculative_) {
+		return speculativeSend(data, fastCgb);
+	}
+	if (is_stopped_ || !link_load(&connected_)) {
+		return 0xFF;
+	}
+	if (!queue(data | (fastCgb ? 1 : 0) << 8)) {
+		return 0xFF;
+	}
+
+	// The clocked byte has gone out, so the transfer has happened on the
+	// other side; returning anything but the peer's answer would leave the
+	// two consoles disagreeing about it. Only a dropped connection ends the
+	// wait early.
+	unsigned spins = 0;
+	for (;;) {
+		unsigned frame;
+		if (rx_.pop(frame)) {
+			// A reply to a request sent before leaving speculative mode.
+			if ((frame >> 8) == reply_marker && stale_ > 0) {
+				--stale_;
+				continue;
+			}
+			// Anything else answers this request; if the peer clocked at the
+			// same time its request counts, as it always has on this link.
+			return frame & 0xFF;
+		}
+		if (!link_load(&connected_))
+			return 0xFF;
+		if (++spins > 1000)
+			link_relax(spins);
+	}
+}
+
+bool NetSerial::check(unsigned char out, unsigned char& in, bool& fastCgb)
+{
+	unsigned frame;
+
+	if (is_stopped_) {
 		return false;
 	}
+	if (speculative_) {
+		return speculativeCheck(out, in, fastCgb);
+	}
+
+	while (rx_.pop(frame)) {
+		// Replies only turn up here for requests sent before leaving
+		// speculative mode.
+		if ((frame >> 8) == reply_marker) {
+			if (stale_ > 0)
+				--stale_;
+			continue;
+		}
+
+//		slave_txn_cnt++;
+
+		in = frame & 0xFF;
+		fastCgb = (frame >> 8) != 0;
+		reply(out);
+		return true;
+	}
+
+	return false;
+}
+
+void NetSerial::reply(unsigned char out)
+{
+	unsigned spins = 0;
+	while (!queue(out | reply_marker << 8) && link_load(&connected_))
+		link_relax(spins);
+}
+
+// Frame numbers wrap; compare them the way the core compares cycle counters.
+static bool before(unsigned a, unsigned b)
+{
+	return static_cast<int>(a - b) < 0;
+}
+
+void NetSerial::setSpeculative(bool speculative)
+{
+	clearJournal();
+	speculative_ = speculative;
+}
 
-//	slave_txn_cnt++;
+void NetSerial::clearJournal()
+{
+	// Requests still in flight will be answered all the same.
+	stale_ += outstanding_.size();
+	sent_.clear();
+	received_.clear();
+	outstanding_.clear();
+	incoming_.clear();
+	sentPos_ = 0;
+	receivedPos_ = 0;
+	frame_ = 0;
+	checks_ = 0;
+	mispredicted_ = false;
+	mispredictedFrame_ = 0;
+	lastReply_ = 0xFF;
+	memset(predicted_, 0xFF, sizeof predicted_);
+	memset(known_, 0, sizeof known_);
+}
 
-	in = buffer[0];
-	fastCgb = buffer[1];
+void NetSerial::beginFrame(unsigned frame)
+{
+	frame_ = frame;
+	checks_ = 0;
+}
+
+// Replay the journal from the start of the given frame: sends that repeat
+// what was sent then get the reply on record instead of a new request, and
+// received bytes are handed over at the same check() as the first time.
+void NetSerial::rewind(unsigned frame)
+{
+	sentPos_ = 0;
+	while (sentPos_ < sent_.size() && before(sent_[sentPos_].frame, frame))
+		++sentPos_;
+	receivedPos_ = 0;
+	while (receivedPos_ < received_.size() && before(received_[receivedPos_].frame, frame))
+		++receivedPos_;
+}
 
-	buffer[0] = out;
-	buffer[1] = 128;
-   #ifdef _WIN32
-      if (::send(sockfd_, (char*) buffer, 2, 0) <= 0)
-   #else
-   	if (write(sockfd_, buffer, 2) <= 0)
-   #endif
-   {
-		gambatte_log(RETRO_LOG_ERROR, "Error writing to socket: %s\n", strerror(errno));
-		close(sockfd_);
-		sockfd_ = -1;
+// Reports the earliest frame holding a guess the peer has since contradicted.
+bool NetSerial::mispredicted(unsigned& frame)
+{
+	drain();
+	if (!mispredicted_)
 		return false;
+
+	frame = mispredictedFrame_;
+	mispredicted_ = false;
+	return true;
+}
+
+// Whether every request sent before the given frame has been answered.
+bool NetSerial::settled(unsigned frame)
+{
+	drain();
+	for (std::size_t i = 0; i < sent_.size() && before(sent_[i].frame, frame); ++i) {
+		if (!sent_[i].confirmed)
+			return false;
+	}
+	return true;
+}
+
+// Blocks until the oldest open request is answered, or the connection drops,
+// which answers it with 0xFF as in the blocking mode.
+void NetSerial::awaitReply()
+{
+	unsigned spins = 0;
+	std::size_t const open = outstanding_.size();
+
+	while (outstanding_.size() == open && open > 0) {
+		unsigned frame;
+		if (rx_.pop(frame)) {
+			route(frame);
+			continue;
+		}
+		if (!link_load(&connected_)) {
+			confirm(0xFF);
+			break;
+		}
+		if (++spins > 1000)
+			link_relax(spins);
 	}
+}
+
+// Drops journal entries older than the given frame, which can no longer be
+// rolled back to.
+void NetSerial::forget(unsigned frame)
+{
+	while (!sent_.empty() && before(sent_.front().frame, frame) && sent_.front().confirmed) {
+		sent_.pop_front();
+		if (sentPos_ > 0)
+			--sentPos_;
+	}
+	while (!received_.empty() && before(received_.front().frame, frame)) {
+		received_.pop_front();
+		if (receivedPos_ > 0)
+			--receivedPos_;
+	}
+}
+
+void NetSerial::drain()
+{
+	unsigned frame;
+	while (rx_.pop(frame))
+		route(frame);
+
+	// Nothing is coming back over a dropped connection.
+	if (!link_load(&connected_)) {
+		while (!outstanding_.empty())
+			confirm(0xFF);
+	}
+}
+
+void NetSerial::route(unsigned frame)
+{
+	if ((frame >> 8) != reply_marker) {
+		incoming_.push_back(frame);
+	} else if (stale_ > 0) {
+		--stale_;
+	} else {
+		confirm(frame & 0xFF);
+	}
+}
+
+// The peer answers requests in the order they were sent.
+void NetSerial::confirm(unsigned char reply)
+{
+	if (outstanding_.empty())
+		return;
+
+	unsigned const id = outstanding_.front();
+	outstanding_.pop_front();
+
+	for (std::size_t i = sent_.size(); i-- > 0;) {
+		Sent& e = sent_[i];
+		if (e.id != id)
+			continue;
+
+		e.confirmed = true;
+		predicted_[e.data] = reply;
+		known_[e.data] = true;
+		lastReply_ = reply;
+		if (e.reply != reply) {
+			e.reply = reply;
+			if (!mispredicted_ || before(e.frame, mispredictedFrame_)) {
+				mispredicted_ = true;
+				mispredictedFrame_ = e.frame;
+			}
+		}
+		break;
+	}
+}
+
+// Most link protocols answer a given byte the same way every time (think of
+// handshakes and idle bytes), so the guess is whatever the peer last answered
+// to this byte, or failing that, whatever it answered last.
+unsigned char NetSerial::speculativeSend(unsigned char data, bool fastCgb)
+{
+	drain();
+
+	if (sentPos_ < sent_.size()) {
+		Sent& e = sent_[sentPos_];
+		if (e.data == data && e.fastCgb == fastCgb) {
+			e.frame = frame_;
+			++sentPos_;
+			return e.reply;
+		}
+		// The replay went its own way. What the peer was sent from here on
+		// cannot be taken back, so those replies are simply ignored.
+		sent_.erase(sent_.begin() + sentPos_, sent_.end());
+	}
+
+	Sent e;
+	e.id = ++nextId_;
+	e.frame = frame_;
+	e.data = data;
+	e.fastCgb = fastCgb;
+	if (!is_stopped_ && link_load(&connected_) && queue(data | (fastCgb ? 1 : 0) << 8)) {
+		e.reply = known_[data] ? predicted_[data] : lastReply_;
+		e.confirmed = false;
+		outstanding_.push_back(e.id);
+	} else {
+		e.reply = 0xFF;
+		e.confirmed = true;
+	}
+	sent_.push_back(e);
+	sentPos_ = sent_.size();
+	return e.reply;
+}
+
+bool NetSerial::speculativeCheck(unsigned char out, unsigned char& in, bool& fastCgb)
+{
+	drain();
+
+	unsigned const checks = checks_++;
+	if (receivedPos_ < received_.size()) {
+		Received const& e = received_[receivedPos_];
+		if (before(frame_, e.frame) || (frame_ == e.frame && checks < e.checks))
+			return false;
+
+		// Already answered the first time round. The answer cannot be taken
+		// back, so a replay that has SB hold something else by now has the
+		// two consoles disagreeing about this transfer.
+		++receivedPos_;
+		if (out != e.replied) {
+			gambatte_log(RETRO_LOG_WARN, "GameLink rollback desync: frame %u answered %02X, replay has %02X.\n",
+					e.frame, e.replied, out);
+		}
+		in = e.data;
+		fastCgb = e.fastCgb;
+		return true;
+	}
+	if (incoming_.empty())
+		return false;
+
+	Received e;
+	e.frame = frame_;
+	e.checks = checks;
+	e.data = incoming_.front() & 0xFF;
+	e.fastCgb = (incoming_.front() >> 8) != 0;
+	e.replied = out;
+	incoming_.pop_front();
+	received_.push_back(e);
+	receivedPos_ = received_.size();
 
+	in = e.data;
+	fastCgb = e.fastCgb;
+	reply(out);
 	return true;
 }
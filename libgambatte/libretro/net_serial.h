@@ -8,34 +8,123 @@
 
 #include <gambatte.h>
 #include <time.h>
+#include <deque>
+#include "link_sync.h"
 
+// GameLink over TCP, or a Unix domain socket for instances on the same host.
+// The socket lives on a dedicated I/O thread; the emulation thread only
+// exchanges frames with it through lock-free queues.
 class NetSerial : public gambatte::SerialIO
 {
 	public:
 		NetSerial();
 		~NetSerial();
 
-		bool start(bool is_server, int port, const std::string& hostname);
+		// A non-empty socketPath selects a Unix domain socket at that path
+		// (HAVE_LOCAL_LINK builds) instead of TCP to hostname:port.
+		bool start(bool is_server, int port, const std::string& hostname,
+				const std::string& socketPath = std::string());
 		void stop();
 
 		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
 		virtual unsigned char send(unsigned char data, bool fastCgb);
 
+		// Speculative mode: send() answers at once with a guess at the peer's
+		// byte, and every transfer is journalled against the frame it happened
+		// in so NetRollback can rewind the console and replay it with the real
+		// bytes. Only used from the emulation thread, between frames.
+		void setSpeculative(bool speculative);
+		bool speculative() const { return speculative_; }
+		void clearJournal();
+		void beginFrame(unsigned frame);
+		void rewind(unsigned frame);
+		bool mispredicted(unsigned& frame);
+		bool settled(unsigned frame);
+		void awaitReply();
+		void forget(unsigned frame);
+
 	private:
+		struct Sent {
+			unsigned id;
+			unsigned frame;
+			unsigned char data;
+			unsigned char reply;
+			bool fastCgb;
+			bool confirmed;
+		};
+
+		struct Received {
+			unsigned frame;
+			unsigned checks;
+			unsigned char data;
+			unsigned char replied;
+			bool fastCgb;
+		};
+
+		unsigned char speculativeSend(unsigned char data, bool fastCgb);
+		bool speculativeCheck(unsigned char out, unsigned char& in, bool& fastCgb);
+		void drain();
+		void route(unsigned frame);
+		void confirm(unsigned char reply);
+		void reply(unsigned char out);
 		bool startServerSocket();
 		bool startClientSocket();
+#ifdef HAVE_LOCAL_LINK
+		bool startLocalServerSocket();
+		bool startLocalClientSocket();
+#endif
 		bool acceptClient();
 		bool checkAndRestoreConnection(bool throttle);
+		void setNoDelay(int fd);
+		void closeConnection();
+		bool openWake();
+		void closeWake();
+		void wake();
+		bool queue(unsigned frame);
+		static void ioEntry(void* self);
+		void ioRun();
+
+		enum { rx_frames = 256, tx_frames = 256 };
 
 		bool is_stopped_;
 		bool is_server_;
 		int  port_;
 		std::string hostname_;
+		std::string socketPath_;
 
 		int server_fd_;
 		int sockfd_;
+		// The I/O thread blocks in select() until the socket or this pair
+		// becomes readable; queueing a frame while it sleeps writes a byte.
+		int wakeRead_;
+		int wakeWrite_;
+
+		time_t lastConnectAttempt_;
+
+		LinkThread thread_;
+		unsigned quit_;
+		unsigned connected_;
+		unsigned sleeping_;
+		unsigned stale_;
+		int partial_;
+		LinkChannel<rx_frames> rx_;
+		LinkChannel<tx_frames> tx_;
 
-		clock_t lastConnectAttempt_;
+		bool speculative_;
+		bool mispredicted_;
+		unsigned mispredictedFrame_;
+		unsigned frame_;
+		unsigned checks_;
+		unsigned nextId_;
+		unsigned char lastReply_;
+		unsigned char predicted_[256];
+		bool known_[256];
+		std::deque<Sent> sent_;
+		std::deque<Received> received_;
+		std::deque<unsigned> outstanding_;
+		std::deque<unsigned> incoming_;
+		std::size_t sentPos_;
+		std::size_t receivedPos_;
 };
 
 #endif
@@ -0,0 +1,279 @@
+/*
+ * Band-limited step resampler to any output rate. See polyphase.h.
+ */
+
+#include "polyphase.h"
+#include "polyphase_filter_bank.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+#define POLYPHASE_X86_DISPATCH
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define POLYPHASE_NEON
+#include <arm_neon.h>
+#endif
+
+#define POLYPHASE_PHASES_LOG2 6
+
+/* Adds n / 2 taps times each channel's step into the interleaved
+ * stereo output. taps holds every tap twice in a row, once per
+ * channel, so the loop runs over both channels at once. */
+typedef void (*polyphase_kernel_t)(int32_t *out, const int16_t *taps,
+      unsigned n, int32_t left, int32_t right);
+
+struct polyphase
+{
+   int32_t *output_buffer;
+   unsigned output_avail;
+   unsigned output_buffer_samples;
+
+   int16_t *filter_bank;
+   unsigned taps;
+
+   /* Position in output samples, 32.32 fixed point, and how far one
+    * input sample moves it. Reading everything leaves it up to one
+    * sample below zero; it wraps, and the sums below wrap back. */
+   uint64_t time;
+   uint64_t step;
+
+   int32_t integrator[2];
+   polyphase_kernel_t kernel;
+};
+
+static void polyphase_kernel_c(int32_t *out, const int16_t *taps,
+      unsigned n, int32_t left, int32_t right)
+{
+   unsigned i;
+
+   for (i = 0; i < n; i += 2)
+   {
+      out[i]     += left  * taps[i];
+      out[i + 1] += right * taps[i + 1];
+   }
+}
+
+/* The vector versions take 4 taps (8 words) at a time; tap counts are
+ * all multiples of 4. */
+
+#ifdef POLYPHASE_X86_DISPATCH
+__attribute__((target("sse2")))
+static void polyphase_kernel_sse2(int32_t *out, const int16_t *taps,
+      unsigned n, int32_t left, int32_t right)
+{
+   /* 16x16 products come out as low and high halves, which interleave
+    * back into 32-bit words */
+   __m128i const step = _mm_set1_epi32((int32_t)((uint32_t)(uint16_t)left | (uint32_t)right << 16));
+   unsigned i;
+
+   for (i = 0; i < n; i += 8)
+   {
+      __m128i const k  = _mm_loadu_si128((const __m128i*)(taps + i));
+      __m128i const lo = _mm_mullo_epi16(step, k);
+      __m128i const hi = _mm_mulhi_epi16(step, k);
+      __m128i *const o = (__m128i*)(out + i);
+
+      _mm_storeu_si128(o,     _mm_add_epi32(_mm_loadu_si128(o),     _mm_unpacklo_epi16(lo, hi)));
+      _mm_storeu_si128(o + 1, _mm_add_epi32(_mm_loadu_si128(o + 1), _mm_unpackhi_epi16(lo, hi)));
+   }
+}
+
+__attribute__((target("avx2")))
+static void polyphase_kernel_avx2(int32_t *out, const int16_t *taps,
+      unsigned n, int32_t left, int32_t right)
+{
+   __m256i const step = _mm256_set_epi32(right, left, right, left, right, left, right, left);
+   unsigned i;
+
+   for (i = 0; i < n; i += 8)
+   {
+      __m256i const k  = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(taps + i)));
+      __m256i *const o = (__m256i*)(out + i);
+
+      _mm256_storeu_si256(o, _mm256_add_epi32(_mm256_loadu_si256(o), _mm256_mullo_epi32(step, k)));
+   }
+}
+
+static polyphase_kernel_t polyphase_pick_kernel(void)
+{
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+      return polyphase_kernel_avx2;
+   if (__builtin_cpu_supports("sse2"))
+      return polyphase_kernel_sse2;
+   return polyphase_kernel_c;
+}
+#elif defined(POLYPHASE_NEON)
+static void polyphase_kernel_neon(int32_t *out, const int16_t *taps,
+      unsigned n, int32_t left, int32_t right)
+{
+   int32_t const pair[4] = { left, right, left, right };
+   int32x4_t const step  = vld1q_s32(pair);
+   unsigned i;
+
+   for (i = 0; i < n; i += 8)
+   {
+      int16x8_t const k = vld1q_s16(taps + i);
+      vst1q_s32(out + i,     vmlaq_s32(vld1q_s32(out + i),     vmovl_s16(vget_low_s16(k)),  step));
+      vst1q_s32(out + i + 4, vmlaq_s32(vld1q_s32(out + i + 4), vmovl_s16(vget_high_s16(k)), step));
+   }
+}
+
+static polyphase_kernel_t polyphase_pick_kernel(void)
+{
+   return polyphase_kernel_neon;
+}
+#else
+static polyphase_kernel_t polyphase_pick_kernel(void)
+{
+   return polyphase_kernel_c;
+}
+#endif
+
+void polyphase_free(polyphase_t *pp)
+{
+   if (pp)
+   {
+      free(pp->filter_bank);
+      free(pp->output_buffer);
+      free(pp);
+   }
+}
+
+void polyphase_reset(polyphase_t *pp)
+{
+   memset(pp->output_buffer, 0,
+         pp->output_buffer_samples * 2 * sizeof(*pp->output_buffer));
+   pp->output_avail  = 0;
+   pp->time          = 0;
+   pp->integrator[0] = 0;
+   pp->integrator[1] = 0;
+}
+
+polyphase_t *polyphase_new(unsigned taps, unsigned long in_rate,
+      unsigned long out_rate, unsigned buffer_samples)
+{
+   const int16_t *bank = NULL;
+   polyphase_t *pp     = NULL;
+   unsigned i;
+
+   switch (taps)
+   {
+      case 8:
+         bank = polyphase_filter_bank_8;
+         break;
+      case 16:
+         bank = polyphase_filter_bank_16;
+         break;
+      case 32:
+         bank = polyphase_filter_bank_32;
+         break;
+      default:
+         return NULL;
+   }
+
+   if (!out_rate || out_rate >= in_rate)
+      return NULL;
+
+   pp = (polyphase_t*)calloc(1, sizeof(*pp));
+   if (!pp)
+      return NULL;
+
+   pp->taps   = taps;
+   pp->step   = ((uint64_t)out_rate << 32) / in_rate;
+   pp->kernel = polyphase_pick_kernel();
+
+   pp->filter_bank = (int16_t*)malloc(POLYPHASE_FILTER_BANK_PHASES * taps * 2
+         * sizeof(*pp->filter_bank));
+   if (!pp->filter_bank)
+      goto error;
+   for (i = 0; i < POLYPHASE_FILTER_BANK_PHASES * taps; i++)
+   {
+      pp->filter_bank[2 * i]     = bank[i];
+      pp->filter_bank[2 * i + 1] = bank[i];
+   }
+
+   pp->output_buffer_samples = buffer_samples + taps;
+   pp->output_buffer = (int32_t*)calloc(pp->output_buffer_samples * 2,
+         sizeof(*pp->output_buffer));
+   if (!pp->output_buffer)
+      goto error;
+
+   return pp;
+
+error:
+   polyphase_free(pp);
+   return NULL;
+}
+
+void polyphase_add_delta(polyphase_t *pp, int32_t left, int32_t right,
+      unsigned clocks)
+{
+   uint64_t const time     = pp->time + clocks * pp->step;
+   /* The step lands on the first output sample at or after it, in the
+    * phase for how far before that sample it is */
+   unsigned const target   = (unsigned)((time + 0xFFFFFFFFu) >> 32);
+   unsigned const phase    = (unsigned)((((uint64_t)target << 32) - time)
+         >> (32 - POLYPHASE_PHASES_LOG2));
+
+   /* Out of room only if the caller stopped reading; drop it rather than
+    * write past the buffer */
+   if (target + pp->taps > pp->output_buffer_samples)
+      return;
+
+   pp->kernel(pp->output_buffer + 2 * target,
+         pp->filter_bank + 2 * pp->taps * phase,
+         2 * pp->taps, left, right);
+}
+
+void polyphase_advance(polyphase_t *pp, unsigned clocks)
+{
+   pp->time        += clocks * pp->step;
+   pp->output_avail = (unsigned)((pp->time + 0xFFFFFFFFu) >> 32);
+}
+
+unsigned polyphase_read_avail(polyphase_t *pp)
+{
+   return pp->output_avail;
+}
+
+void polyphase_read(polyphase_t *pp, int16_t *output, unsigned samples)
+{
+   const int32_t *in = pp->output_buffer;
+   unsigned s, c;
+
+   for (c = 0; c < 2; c++)
+   {
+      int32_t sum = pp->integrator[c];
+
+      for (s = 0; s < samples; s++)
+      {
+         int32_t quant;
+
+         /* Leaky, like blipper's, against DC drift */
+         sum += in[2 * s + c] - (sum >> 9);
+
+         /* Steps are in Q14 */
+         quant = (sum + 0x2000) >> 14;
+         if (quant != (int16_t)quant)
+         {
+            quant = quant < 0 ? -0x8000 : 0x7FFF;
+            sum   = quant << 14;
+         }
+
+         output[2 * s + c] = (int16_t)quant;
+      }
+
+      pp->integrator[c] = sum;
+   }
+
+   memmove(pp->output_buffer, pp->output_buffer + 2 * samples,
+         (pp->output_avail + pp->taps - samples) * 2 * sizeof(*in));
+   memset(pp->output_buffer + 2 * (pp->output_avail + pp->taps - samples), 0,
+         samples * 2 * sizeof(*in));
+   pp->output_avail -= samples;
+   pp->time         -= (uint64_t)samples << 32;
+}
@@ -0,0 +1,75 @@
+/*
+ * Band-limited step resampler to any output rate.
+ *
+ * Works like blipper, on the steps in the signal rather than on its
+ * samples, but with a fractional ratio between the input and output
+ * rates, so that the core can output at the rate of the sound device
+ * and the frontend does not have to resample a second time. Each step
+ * is drawn in as one phase of a polyphase filter bank, picked by where
+ * the step falls between two output samples. Both stereo channels go
+ * through one pass. Fixed-point only, int16 in/out, int32 intermediate;
+ * the inner loop has SSE2, AVX2 and NEON versions, picked at runtime
+ * where it can be, which give the same output as the C one.
+ */
+
+#ifndef POLYPHASE_H__
+#define POLYPHASE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef struct polyphase polyphase_t;
+
+/* Create a new resampler.
+ * taps: Number of filter taps per step. 8, 16 or 32; more taps give a
+ * steeper cutoff for more work per step.
+ *
+ * in_rate, out_rate: Input and output rates in Hz. The input rate must
+ * be above the output rate.
+ *
+ * buffer_samples: The maximum number of processed output samples that
+ * can be buffered up.
+ *
+ * Returns NULL on an unsupported tap count or out of memory.
+ */
+polyphase_t *polyphase_new(unsigned taps, unsigned long in_rate,
+      unsigned long out_rate, unsigned buffer_samples);
+
+/* Reset the resampler to its initial state. */
+void polyphase_reset(polyphase_t *pp);
+
+/* Frees the resampler. pp can be NULL (no-op). */
+void polyphase_free(polyphase_t *pp);
+
+/* Add a step in each channel at clocks input samples past the current
+ * position, without moving the position. Steps can come in any order,
+ * as long as none of them lands before the current position. Both must
+ * fit in int16. Follow up with polyphase_advance().
+ */
+void polyphase_add_delta(polyphase_t *pp, int32_t left, int32_t right,
+      unsigned clocks);
+
+/* Move the position forward by clocks input samples, past the steps
+ * added with polyphase_add_delta(), making them available for reading.
+ */
+void polyphase_advance(polyphase_t *pp, unsigned clocks);
+
+/* Returns the number of stereo samples available for reading using
+ * polyphase_read().
+ */
+unsigned polyphase_read_avail(polyphase_t *pp);
+
+/* Reads processed samples into an interleaved stereo buffer. The caller
+ * must ensure to not read more than what is returned from
+ * polyphase_read_avail().
+ */
+void polyphase_read(polyphase_t *pp, int16_t *output, unsigned samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
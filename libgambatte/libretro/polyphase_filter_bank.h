@@ -0,0 +1,485 @@
+/*
+ * Precomputed fixed-point (int16) polyphase filter banks for the
+ * gambatte arbitrary-rate resampler (polyphase.c).
+ *
+ * phases = 64 for every bank. Each phase holds the taps of a
+ * Kaiser-windowed sinc impulse, offset by phase/64 of an output
+ * sample, with the cutoff given relative to the output Nyquist rate:
+ *
+ *   taps = 8   cutoff = 0.70  beta = 5.0
+ *   taps = 16  cutoff = 0.80  beta = 6.0
+ *   taps = 32  cutoff = 0.85  beta = 6.5
+ *
+ * Every phase is quantized with floor(coeff / sum * 0x4000 + 0.5) and
+ * the rounding error is then taken up by the centre tap, so each phase
+ * sums to exactly 0x4000 (1.0 in Q14) and a step settles on precisely
+ * its level. Like blipper_filter_bank.h, the taps are baked rather than
+ * synthesized at runtime so the resampler needs neither libm nor
+ * floating point, and its output is bit-identical on every target.
+ */
+
+#ifndef POLYPHASE_FILTER_BANK_H__
+#define POLYPHASE_FILTER_BANK_H__
+
+#include <stdint.h>
+
+#define POLYPHASE_FILTER_BANK_PHASES 64
+
+static const int16_t polyphase_filter_bank_8[POLYPHASE_FILTER_BANK_PHASES * 8] = {
+       28,   124, -1376,  3675, 11510,  3675, -1376,   124,
+       31,   114, -1384,  3841, 11504,  3510, -1366,   134,
+       34,   102, -1390,  4008, 11495,  3346, -1354,   143,
+       37,    90, -1394,  4176, 11480,  3184, -1341,   152,
+       41,    78, -1396,  4345, 11460,  3023, -1326,   159,
+       44,    64, -1396,  4516, 11434,  2865, -1309,   166,
+       48,    50, -1394,  4687, 11402,  2709, -1291,   173,
+       51,    35, -1389,  4858, 11367,  2555, -1272,   179,
+       55,    19, -1382,  5031, 11326,  2403, -1252,   184,
+       59,     2, -1373,  5204, 11280,  2254, -1230,   188,
+       63,   -15, -1362,  5377, 11229,  2107, -1207,   192,
+       68,   -33, -1348,  5550, 11173,  1962, -1184,   196,
+       72,   -52, -1332,  5723, 11114,  1820, -1159,   198,
+       76,   -71, -1313,  5897, 11046,  1681, -1133,   201,
+       81,   -91, -1291,  6070, 10976,  1544, -1107,   202,
+       86,  -112, -1267,  6242, 10901,  1410, -1080,   204,
+       90,  -134, -1240,  6414, 10823,  1279, -1052,   204,
+       95,  -157, -1210,  6586, 10737,  1151, -1023,   205,
+      100,  -180, -1177,  6756, 10648,  1026,  -994,   205,
+      105,  -203, -1141,  6926, 10554,   904,  -965,   204,
+      110,  -228, -1102,  7095, 10456,   785,  -935,   203,
+      115,  -253, -1061,  7262, 10354,   669,  -904,   202,
+      120,  -279, -1016,  7428, 10249,   556,  -874,   200,
+      125,  -305,  -968,  7593, 10137,   447,  -843,   198,
+      130,  -332,  -917,  7755, 10024,   340,  -812,   196,
+      135,  -359,  -863,  7916,  9906,   237,  -781,   193,
+      140,  -387,  -806,  8075,  9784,   137,  -749,   190,
+      144,  -415,  -745,  8232,  9659,    40,  -718,   187,
+      149,  -444,  -681,  8387,  9530,   -53,  -687,   183,
+      154,  -474,  -614,  8540,  9397,  -143,  -656,   180,
+      159,  -503,  -544,  8690,  9261,  -230,  -625,   176,
+      163,  -533,  -470,  8837,  9122,  -313,  -594,   172,
+      167,  -563,  -394,  8982,  8982,  -394,  -563,   167,
+      172,  -594,  -313,  9123,  8836,  -470,  -533,   163,
+      176,  -625,  -230,  9262,  8689,  -544,  -503,   159,
+      180,  -656,  -143,  9397,  8540,  -614,  -474,   154,
+      183,  -687,   -53,  9530,  8387,  -681,  -444,   149,
+      187,  -718,    40,  9659,  8232,  -745,  -415,   144,
+      190,  -749,   137,  9784,  8075,  -806,  -387,   140,
+      193,  -781,   237,  9906,  7916,  -863,  -359,   135,
+      196,  -812,   340, 10024,  7755,  -917,  -332,   130,
+      198,  -843,   447, 10138,  7592,  -968,  -305,   125,
+      200,  -874,   556, 10248,  7429, -1016,  -279,   120,
+      202,  -904,   669, 10354,  7262, -1061,  -253,   115,
+      203,  -935,   785, 10456,  7095, -1102,  -228,   110,
+      204,  -965,   904, 10554,  6926, -1141,  -203,   105,
+      205,  -994,  1026, 10648,  6756, -1177,  -180,   100,
+      205, -1023,  1151, 10737,  6586, -1210,  -157,    95,
+      204, -1052,  1279, 10821,  6416, -1240,  -134,    90,
+      204, -1080,  1410, 10901,  6242, -1267,  -112,    86,
+      202, -1107,  1544, 10976,  6070, -1291,   -91,    81,
+      201, -1133,  1681, 11047,  5896, -1313,   -71,    76,
+      198, -1159,  1820, 11112,  5725, -1332,   -52,    72,
+      196, -1184,  1962, 11173,  5550, -1348,   -33,    68,
+      192, -1207,  2107, 11229,  5377, -1362,   -15,    63,
+      188, -1230,  2254, 11280,  5204, -1373,     2,    59,
+      184, -1252,  2403, 11326,  5031, -1382,    19,    55,
+      179, -1272,  2555, 11367,  4858, -1389,    35,    51,
+      173, -1291,  2709, 11403,  4686, -1394,    50,    48,
+      166, -1309,  2865, 11433,  4517, -1396,    64,    44,
+      159, -1326,  3023, 11459,  4346, -1396,    78,    41,
+      152, -1341,  3184, 11479,  4177, -1394,    90,    37,
+      143, -1354,  3346, 11494,  4009, -1390,   102,    34,
+      134, -1366,  3510, 11504,  3841, -1384,   114,    31
+};
+
+static const int16_t polyphase_filter_bank_16[POLYPHASE_FILTER_BANK_PHASES * 16] = {
+        9,   -48,    84,     0,  -370,  1111, -2086,  2939,
+    13115,  2939, -2086,  1111,  -370,     0,    84,   -48,
+        9,   -49,    89,   -13,  -354,  1107, -2134,  3148,
+    13114,  2731, -2036,  1114,  -386,    12,    78,   -46,
+       10,   -51,    95,   -26,  -336,  1100, -2179,  3360,
+    13104,  2526, -1984,  1115,  -401,    24,    72,   -45,
+       10,   -52,   101,   -39,  -317,  1092, -2221,  3574,
+    13083,  2324, -1930,  1114,  -415,    36,    67,   -43,
+       10,   -53,   106,   -52,  -298,  1081, -2261,  3790,
+    13060,  2124, -1874,  1111,  -428,    48,    61,   -41,
+       10,   -55,   112,   -66,  -277,  1069, -2298,  4008,
+    13028,  1928, -1816,  1107,  -440,    59,    55,   -40,
+       10,   -56,   118,   -80,  -256,  1055, -2331,  4227,
+    12989,  1734, -1757,  1100,  -451,    70,    50,   -38,
+       10,   -57,   123,   -94,  -234,  1038, -2362,  4447,
+    12944,  1544, -1695,  1092,  -461,    80,    45,   -36,
+       10,   -58,   129,  -108,  -211,  1020, -2390,  4669,
+    12892,  1357, -1633,  1083,  -470,    90,    39,   -35,
+       10,   -59,   134,  -122,  -187,  1000, -2414,  4891,
+    12832,  1174, -1569,  1072,  -479,   100,    34,   -33,
+       10,   -60,   139,  -137,  -162,   977, -2435,  5114,
+    12766,   995, -1503,  1059,  -486,   109,    29,   -31,
+       10,   -61,   144,  -151,  -137,   953, -2453,  5338,
+    12694,   819, -1437,  1045,  -492,   118,    24,   -30,
+       10,   -62,   150,  -166,  -111,   926, -2467,  5562,
+    12615,   647, -1370,  1030,  -497,   126,    19,   -28,
+       10,   -63,   154,  -180,   -84,   897, -2477,  5787,
+    12529,   479, -1301,  1013,  -502,   134,    14,   -26,
+       10,   -63,   159,  -195,   -57,   867, -2483,  6011,
+    12437,   315, -1233,   995,  -505,   142,     9,   -25,
+       10,   -64,   164,  -210,   -29,   834, -2485,  6235,
+    12340,   155, -1163,   975,  -508,   149,     4,   -23,
+       10,   -64,   168,  -224,     0,   800, -2484,  6459,
+    12233,     0, -1093,   954,  -510,   156,     0,   -21,
+        9,   -64,   173,  -239,    29,   763, -2478,  6682,
+    12122,  -151, -1023,   933,  -510,   162,    -4,   -20,
+        9,   -64,   177,  -253,    59,   725, -2468,  6904,
+    12004,  -298,  -952,   910,  -510,   168,    -9,   -18,
+        9,   -64,   181,  -268,    89,   684, -2454,  7125,
+    11885,  -440,  -882,   886,  -510,   173,   -13,   -17,
+        8,   -64,   184,  -282,   120,   642, -2436,  7345,
+    11756,  -577,  -811,   861,  -508,   178,   -17,   -15,
+        8,   -64,   188,  -296,   151,   598, -2413,  7563,
+    11621,  -710,  -741,   835,  -505,   183,   -20,   -14,
+        7,   -64,   191,  -310,   183,   551, -2386,  7780,
+    11484,  -839,  -670,   808,  -502,   187,   -24,   -12,
+        7,   -63,   194,  -323,   214,   504, -2354,  7995,
+    11338,  -962,  -600,   780,  -498,   191,   -28,   -11,
+        6,   -62,   196,  -337,   246,   454, -2317,  8209,
+    11188, -1081,  -531,   752,  -493,   194,   -31,    -9,
+        6,   -62,   199,  -350,   279,   403, -2276,  8419,
+    11033, -1195,  -462,   723,  -488,   197,   -34,    -8,
+        5,   -61,   201,  -363,   311,   350, -2231,  8628,
+    10873, -1304,  -393,   694,  -482,   200,   -37,    -7,
+        4,   -59,   203,  -375,   344,   295, -2180,  8834,
+    10707, -1408,  -325,   663,  -475,   202,   -40,    -6,
+        4,   -58,   204,  -387,   376,   239, -2125,  9037,
+    10536, -1507,  -258,   633,  -467,   204,   -43,    -4,
+        3,   -57,   205,  -399,   409,   181, -2065,  9237,
+    10364, -1602,  -192,   602,  -459,   205,   -45,    -3,
+        2,   -55,   206,  -410,   441,   122, -2000,  9434,
+    10185, -1691,  -127,   570,  -450,   206,   -47,    -2,
+        1,   -54,   207,  -421,   474,    62, -1930,  9627,
+    10004, -1776,   -63,   538,  -441,   207,   -50,    -1,
+        0,   -52,   207,  -431,   506,     0, -1855,  9817,
+     9817, -1855,     0,   506,  -431,   207,   -52,     0,
+       -1,   -50,   207,  -441,   538,   -63, -1776, 10003,
+     9628, -1930,    62,   474,  -421,   207,   -54,     1,
+       -2,   -47,   206,  -450,   570,  -127, -1691, 10186,
+     9433, -2000,   122,   441,  -410,   206,   -55,     2,
+       -3,   -45,   205,  -459,   602,  -192, -1602, 10364,
+     9237, -2065,   181,   409,  -399,   205,   -57,     3,
+       -4,   -43,   204,  -467,   633,  -258, -1507, 10538,
+     9035, -2125,   239,   376,  -387,   204,   -58,     4,
+       -6,   -40,   202,  -475,   663,  -325, -1408, 10707,
+     8834, -2180,   295,   344,  -375,   203,   -59,     4,
+       -7,   -37,   200,  -482,   694,  -393, -1304, 10872,
+     8629, -2231,   350,   311,  -363,   201,   -61,     5,
+       -8,   -34,   197,  -488,   723,  -462, -1195, 11032,
+     8420, -2276,   403,   279,  -350,   199,   -62,     6,
+       -9,   -31,   194,  -493,   752,  -531, -1081, 11187,
+     8210, -2317,   454,   246,  -337,   196,   -62,     6,
+      -11,   -28,   191,  -498,   780,  -600,  -962, 11337,
+     7996, -2354,   504,   214,  -323,   194,   -63,     7,
+      -12,   -24,   187,  -502,   808,  -670,  -839, 11482,
+     7782, -2386,   551,   183,  -310,   191,   -64,     7,
+      -14,   -20,   183,  -505,   835,  -741,  -710, 11622,
+     7562, -2413,   598,   151,  -296,   188,   -64,     8,
+      -15,   -17,   178,  -508,   861,  -811,  -577, 11756,
+     7345, -2436,   642,   120,  -282,   184,   -64,     8,
+      -17,   -13,   173,  -510,   886,  -882,  -440, 11884,
+     7126, -2454,   684,    89,  -268,   181,   -64,     9,
+      -18,    -9,   168,  -510,   910,  -952,  -298, 12007,
+     6901, -2468,   725,    59,  -253,   177,   -64,     9,
+      -20,    -4,   162,  -510,   933, -1023,  -151, 12123,
+     6681, -2478,   763,    29,  -239,   173,   -64,     9,
+      -21,     0,   156,  -510,   954, -1093,     0, 12234,
+     6458, -2484,   800,     0,  -224,   168,   -64,    10,
+      -23,     4,   149,  -508,   975, -1163,   155, 12339,
+     6236, -2485,   834,   -29,  -210,   164,   -64,    10,
+      -25,     9,   142,  -505,   995, -1233,   315, 12437,
+     6011, -2483,   867,   -57,  -195,   159,   -63,    10,
+      -26,    14,   134,  -502,  1013, -1301,   479, 12529,
+     5787, -2477,   897,   -84,  -180,   154,   -63,    10,
+      -28,    19,   126,  -497,  1030, -1370,   647, 12615,
+     5562, -2467,   926,  -111,  -166,   150,   -62,    10,
+      -30,    24,   118,  -492,  1045, -1437,   819, 12694,
+     5338, -2453,   953,  -137,  -151,   144,   -61,    10,
+      -31,    29,   109,  -486,  1059, -1503,   995, 12766,
+     5114, -2435,   977,  -162,  -137,   139,   -60,    10,
+      -33,    34,   100,  -479,  1072, -1569,  1174, 12832,
+     4891, -2414,  1000,  -187,  -122,   134,   -59,    10,
+      -35,    39,    90,  -470,  1083, -1633,  1357, 12891,
+     4670, -2390,  1020,  -211,  -108,   129,   -58,    10,
+      -36,    45,    80,  -461,  1092, -1695,  1544, 12944,
+     4447, -2362,  1038,  -234,   -94,   123,   -57,    10,
+      -38,    50,    70,  -451,  1100, -1757,  1734, 12989,
+     4227, -2331,  1055,  -256,   -80,   118,   -56,    10,
+      -40,    55,    59,  -440,  1107, -1816,  1928, 13028,
+     4008, -2298,  1069,  -277,   -66,   112,   -55,    10,
+      -41,    61,    48,  -428,  1111, -1874,  2124, 13059,
+     3791, -2261,  1081,  -298,   -52,   106,   -53,    10,
+      -43,    67,    36,  -415,  1114, -1930,  2324, 13084,
+     3573, -2221,  1092,  -317,   -39,   101,   -52,    10,
+      -45,    72,    24,  -401,  1115, -1984,  2526, 13102,
+     3362, -2179,  1100,  -336,   -26,    95,   -51,    10,
+      -46,    78,    12,  -386,  1114, -2036,  2731, 13112,
+     3150, -2134,  1107,  -354,   -13,    89,   -49,     9
+};
+
+static const int16_t polyphase_filter_bank_32[POLYPHASE_FILTER_BANK_PHASES * 32] = {
+       -3,     6,    -6,    -6,    35,   -84,   143,  -185,
+      173,   -64,  -174,   547, -1026,  1544, -2013,  2340,
+    13927,  2340, -2013,  1544, -1026,   547,  -174,   -64,
+      173,  -185,   143,   -84,    35,    -6,    -6,     6,
+       -3,     7,    -7,    -4,    33,   -83,   144,  -190,
+      184,   -81,  -152,   526, -1017,  1563, -2090,  2570,
+    13921,  2112, -1933,  1523, -1033,   567,  -195,   -47,
+      162,  -180,   142,   -86,    37,    -7,    -5,     6,
+       -3,     7,    -8,    -3,    32,   -82,   144,  -194,
+      194,   -98,  -130,   505, -1005,  1579, -2165,  2804,
+    13906,  1889, -1852,  1500, -1039,   585,  -216,   -30,
+      151,  -175,   141,   -86,    39,    -8,    -4,     6,
+       -3,     7,    -8,    -1,    30,   -80,   144,  -199,
+      205,  -116,  -107,   482,  -992,  1593, -2237,  3041,
+    13887,  1668, -1769,  1474, -1042,   602,  -236,   -13,
+      140,  -169,   139,   -87,    40,   -10,    -4,     5,
+       -3,     8,    -9,     0,    28,   -78,   144,  -203,
+      215,  -133,   -84,   458,  -977,  1604, -2306,  3280,
+    13858,  1451, -1684,  1445, -1044,   618,  -255,     4,
+      128,  -163,   137,   -88,    42,   -11,    -3,     5,
+       -3,     8,   -10,     2,    25,   -76,   144,  -206,
+      224,  -150,   -61,   433,  -960,  1612, -2373,  3521,
+    13822,  1239, -1598,  1415, -1044,   632,  -274,    21,
+      117,  -157,   135,   -88,    43,   -12,    -2,     5,
+       -3,     8,   -11,     3,    23,   -74,   143,  -210,
+      234,  -167,   -37,   407,  -942,  1618, -2437,  3765,
+    13780,  1030, -1510,  1383, -1042,   646,  -292,    37,
+      105,  -151,   133,   -89,    44,   -13,    -1,     4,
+       -4,     9,   -12,     5,    21,   -72,   143,  -213,
+      243,  -184,   -13,   380,  -921,  1620, -2497,  4010,
+    13728,   826, -1421,  1348, -1039,   658,  -310,    53,
+       94,  -144,   131,   -89,    45,   -15,     0,     4,
+       -4,     9,   -13,     7,    18,   -69,   142,  -215,
+      252,  -201,    11,   352,  -898,  1620, -2554,  4258,
+    13666,   626, -1331,  1312, -1033,   669,  -326,    69,
+       82,  -138,   128,   -89,    46,   -16,     0,     4,
+       -4,     9,   -13,     8,    16,   -67,   140,  -217,
+      260,  -217,    36,   323,  -874,  1617, -2608,  4507,
+    13599,   430, -1240,  1274, -1026,   678,  -342,    85,
+       70,  -131,   126,   -89,    47,   -17,     1,     3,
+       -4,    10,   -14,    10,    14,   -64,   139,  -219,
+      268,  -234,    61,   293,  -848,  1611, -2658,  4757,
+    13520,   240, -1148,  1234, -1017,   687,  -358,   100,
+       58,  -124,   123,   -88,    48,   -18,     2,     3,
+       -4,    10,   -15,    12,    11,   -61,   137,  -221,
+      276,  -250,    86,   262,  -820,  1603, -2704,  5009,
+    13436,    54, -1056,  1192, -1006,   694,  -372,   115,
+       47,  -117,   120,   -88,    49,   -19,     2,     2,
+       -4,    10,   -16,    13,     8,   -58,   135,  -222,
+      283,  -266,   111,   231,  -790,  1591, -2746,  5261,
+    13347,  -127,  -964,  1149,  -994,   699,  -386,   130,
+       35,  -109,   116,   -87,    49,   -20,     3,     2,
+       -4,    10,   -17,    15,     6,   -55,   132,  -223,
+      290,  -281,   136,   199,  -759,  1576, -2784,  5514,
+    13245,  -303,  -871,  1104,  -980,   704,  -399,   144,
+       24,  -102,   113,   -86,    50,   -20,     4,     2,
+       -4,    11,   -17,    17,     3,   -51,   130,  -223,
+      297,  -296,   161,   166,  -726,  1558, -2818,  5767,
+    13140,  -474,  -778,  1058,  -965,   707,  -411,   158,
+       12,   -95,   109,   -86,    50,   -21,     4,     1,
+       -4,    11,   -18,    18,     0,   -48,   127,  -223,
+      303,  -311,   186,   133,  -691,  1538, -2848,  6020,
+    13025,  -639,  -685,  1010,  -948,   709,  -422,   171,
+        1,   -87,   105,   -84,    51,   -22,     5,     1,
+       -4,    11,   -19,    20,    -3,   -44,   124,  -223,
+      308,  -326,   211,    99,  -654,  1514, -2873,  6273,
+    12904,  -799,  -593,   962,  -929,   709,  -432,   184,
+      -11,   -79,   102,   -83,    51,   -23,     6,     1,
+       -4,    11,   -20,    22,    -6,   -40,   120,  -222,
+      313,  -340,   236,    64,  -616,  1487, -2893,  6526,
+    12777,  -954,  -501,   912,  -909,   709,  -442,   197,
+      -22,   -72,    98,   -82,    51,   -23,     6,     1,
+       -4,    11,   -20,    23,    -8,   -36,   116,  -221,
+      317,  -353,   260,    29,  -577,  1457, -2909,  6779,
+    12643, -1103,  -409,   861,  -888,   707,  -450,   209,
+      -33,   -64,    93,   -80,    51,   -24,     7,     0,
+       -4,    12,   -21,    25,   -11,   -32,   112,  -219,
+      321,  -366,   285,    -6,  -536,  1425, -2920,  7030,
+    12497, -1246,  -318,   810,  -865,   704,  -458,   221,
+      -44,   -56,    89,   -79,    51,   -24,     7,     0,
+       -4,    12,   -22,    26,   -14,   -28,   108,  -217,
+      325,  -379,   309,   -42,  -493,  1389, -2926,  7280,
+    12351, -1384,  -228,   757,  -841,   699,  -465,   232,
+      -54,   -49,    85,   -77,    51,   -25,     8,     0,
+       -4,    12,   -22,    28,   -17,   -24,   104,  -215,
+      328,  -391,   333,   -78,  -450,  1350, -2927,  7530,
+    12197, -1516,  -139,   704,  -816,   694,  -471,   242,
+      -65,   -41,    80,   -75,    51,   -25,     8,    -1,
+       -4,    12,   -23,    30,   -20,   -20,    99,  -212,
+      330,  -402,   356,  -114,  -405,  1309, -2922,  7777,
+    12035, -1642,   -51,   650,  -790,   687,  -476,   252,
+      -75,   -33,    76,   -73,    51,   -26,     9,    -1,
+       -4,    12,   -23,    31,   -23,   -15,    94,  -208,
+      332,  -413,   379,  -151,  -358,  1264, -2913,  8023,
+    11867, -1762,    36,   596,  -763,   679,  -480,   262,
+      -85,   -25,    71,   -71,    50,   -26,     9,    -1,
+       -4,    12,   -24,    33,   -26,   -11,    89,  -205,
+      333,  -423,   402,  -187,  -311,  1217, -2898,  8266,
+    11695, -1876,   121,   541,  -734,   670,  -484,   271,
+      -94,   -18,    66,   -69,    50,   -26,     9,    -1,
+       -4,    12,   -24,    34,   -29,    -6,    84,  -201,
+      334,  -432,   424,  -224,  -263,  1167, -2877,  8508,
+    11514, -1984,   205,   486,  -705,   660,  -486,   279,
+     -104,   -10,    62,   -67,    49,   -26,    10,    -2,
+       -4,    12,   -25,    36,   -32,    -2,    78,  -196,
+      334,  -441,   446,  -261,  -213,  1114, -2851,  8747,
+    11332, -2087,   287,   431,  -674,   649,  -488,   287,
+     -113,    -3,    57,   -65,    48,   -27,    10,    -2,
+       -4,    12,   -25,    37,   -35,     3,    72,  -191,
+      333,  -449,   467,  -297,  -163,  1058, -2820,  8983,
+    11140, -2183,   368,   376,  -643,   637,  -488,   294,
+     -122,     5,    52,   -62,    48,   -27,    10,    -2,
+       -3,    12,   -25,    38,   -38,     8,    66,  -186,
+      332,  -457,   487,  -333,  -111,  1000, -2782,  9216,
+    10941, -2273,   447,   321,  -611,   624,  -488,   301,
+     -130,    12,    47,   -60,    47,   -27,    11,    -2,
+       -3,    12,   -26,    40,   -41,    13,    60,  -180,
+      330,  -463,   507,  -370,   -59,   939, -2739,  9445,
+    10742, -2358,   524,   265,  -578,   610,  -487,   307,
+     -138,    19,    42,   -57,    46,   -27,    11,    -2,
+       -3,    12,   -26,    41,   -44,    17,    54,  -174,
+      328,  -469,   526,  -405,    -6,   876, -2690,  9672,
+    10536, -2436,   599,   210,  -545,   595,  -485,   312,
+     -146,    27,    37,   -55,    45,   -27,    11,    -3,
+       -3,    12,   -26,    42,   -46,    22,    47,  -168,
+      325,  -474,   545,  -441,    47,   810, -2636,  9894,
+    10328, -2509,   671,   156,  -511,   579,  -482,   317,
+     -154,    34,    32,   -52,    44,   -27,    11,    -3,
+       -3,    12,   -26,    43,   -49,    27,    40,  -161,
+      321,  -479,   562,  -476,   101,   742, -2575, 10113,
+    10113, -2575,   742,   101,  -476,   562,  -479,   321,
+     -161,    40,    27,   -49,    43,   -26,    12,    -3,
+       -3,    11,   -27,    44,   -52,    32,    34,  -154,
+      317,  -482,   579,  -511,   156,   671, -2509, 10327,
+     9895, -2636,   810,    47,  -441,   545,  -474,   325,
+     -168,    47,    22,   -46,    42,   -26,    12,    -3,
+       -3,    11,   -27,    45,   -55,    37,    27,  -146,
+      312,  -485,   595,  -545,   210,   599, -2436, 10537,
+     9671, -2690,   876,    -6,  -405,   526,  -469,   328,
+     -174,    54,    17,   -44,    41,   -26,    12,    -3,
+       -2,    11,   -27,    46,   -57,    42,    19,  -138,
+      307,  -487,   610,  -578,   265,   524, -2358, 10743,
+     9444, -2739,   939,   -59,  -370,   507,  -463,   330,
+     -180,    60,    13,   -41,    40,   -26,    12,    -3,
+       -2,    11,   -27,    47,   -60,    47,    12,  -130,
+      301,  -488,   624,  -611,   321,   447, -2273, 10943,
+     9214, -2782,  1000,  -111,  -333,   487,  -457,   332,
+     -186,    66,     8,   -38,    38,   -25,    12,    -3,
+       -2,    10,   -27,    48,   -62,    52,     5,  -122,
+      294,  -488,   637,  -643,   376,   368, -2183, 11139,
+     8984, -2820,  1058,  -163,  -297,   467,  -449,   333,
+     -191,    72,     3,   -35,    37,   -25,    12,    -4,
+       -2,    10,   -27,    48,   -65,    57,    -3,  -113,
+      287,  -488,   649,  -674,   431,   287, -2087, 11329,
+     8750, -2851,  1114,  -213,  -261,   446,  -441,   334,
+     -196,    78,    -2,   -32,    36,   -25,    12,    -4,
+       -2,    10,   -26,    49,   -67,    62,   -10,  -104,
+      279,  -486,   660,  -705,   486,   205, -1984, 11514,
+     8508, -2877,  1167,  -263,  -224,   424,  -432,   334,
+     -201,    84,    -6,   -29,    34,   -24,    12,    -4,
+       -1,     9,   -26,    50,   -69,    66,   -18,   -94,
+      271,  -484,   670,  -734,   541,   121, -1876, 11694,
+     8267, -2898,  1217,  -311,  -187,   402,  -423,   333,
+     -205,    89,   -11,   -26,    33,   -24,    12,    -4,
+       -1,     9,   -26,    50,   -71,    71,   -25,   -85,
+      262,  -480,   679,  -763,   596,    36, -1762, 11867,
+     8023, -2913,  1264,  -358,  -151,   379,  -413,   332,
+     -208,    94,   -15,   -23,    31,   -23,    12,    -4,
+       -1,     9,   -26,    51,   -73,    76,   -33,   -75,
+      252,  -476,   687,  -790,   650,   -51, -1642, 12035,
+     7777, -2922,  1309,  -405,  -114,   356,  -402,   330,
+     -212,    99,   -20,   -20,    30,   -23,    12,    -4,
+       -1,     8,   -25,    51,   -75,    80,   -41,   -65,
+      242,  -471,   694,  -816,   704,  -139, -1516, 12196,
+     7531, -2927,  1350,  -450,   -78,   333,  -391,   328,
+     -215,   104,   -24,   -17,    28,   -22,    12,    -4,
+        0,     8,   -25,    51,   -77,    85,   -49,   -54,
+      232,  -465,   699,  -841,   757,  -228, -1384, 12351,
+     7280, -2926,  1389,  -493,   -42,   309,  -379,   325,
+     -217,   108,   -28,   -14,    26,   -22,    12,    -4,
+        0,     7,   -24,    51,   -79,    89,   -56,   -44,
+      221,  -458,   704,  -865,   810,  -318, -1246, 12500,
+     7027, -2920,  1425,  -536,    -6,   285,  -366,   321,
+     -219,   112,   -32,   -11,    25,   -21,    12,    -4,
+        0,     7,   -24,    51,   -80,    93,   -64,   -33,
+      209,  -450,   707,  -888,   861,  -409, -1103, 12642,
+     6780, -2909,  1457,  -577,    29,   260,  -353,   317,
+     -221,   116,   -36,    -8,    23,   -20,    11,    -4,
+        1,     6,   -23,    51,   -82,    98,   -72,   -22,
+      197,  -442,   709,  -909,   912,  -501,  -954, 12777,
+     6526, -2893,  1487,  -616,    64,   236,  -340,   313,
+     -222,   120,   -40,    -6,    22,   -20,    11,    -4,
+        1,     6,   -23,    51,   -83,   102,   -79,   -11,
+      184,  -432,   709,  -929,   962,  -593,  -799, 12905,
+     6272, -2873,  1514,  -654,    99,   211,  -326,   308,
+     -223,   124,   -44,    -3,    20,   -19,    11,    -4,
+        1,     5,   -22,    51,   -84,   105,   -87,     1,
+      171,  -422,   709,  -948,  1010,  -685,  -639, 13026,
+     6019, -2848,  1538,  -691,   133,   186,  -311,   303,
+     -223,   127,   -48,     0,    18,   -18,    11,    -4,
+        1,     4,   -21,    50,   -86,   109,   -95,    12,
+      158,  -411,   707,  -965,  1058,  -778,  -474, 13140,
+     5767, -2818,  1558,  -726,   166,   161,  -296,   297,
+     -223,   130,   -51,     3,    17,   -17,    11,    -4,
+        2,     4,   -20,    50,   -86,   113,  -102,    24,
+      144,  -399,   704,  -980,  1104,  -871,  -303, 13247,
+     5512, -2784,  1576,  -759,   199,   136,  -281,   290,
+     -223,   132,   -55,     6,    15,   -17,    10,    -4,
+        2,     3,   -20,    49,   -87,   116,  -109,    35,
+      130,  -386,   699,  -994,  1149,  -964,  -127, 13346,
+     5262, -2746,  1591,  -790,   231,   111,  -266,   283,
+     -222,   135,   -58,     8,    13,   -16,    10,    -4,
+        2,     2,   -19,    49,   -88,   120,  -117,    47,
+      115,  -372,   694, -1006,  1192, -1056,    54, 13437,
+     5008, -2704,  1603,  -820,   262,    86,  -250,   276,
+     -221,   137,   -61,    11,    12,   -15,    10,    -4,
+        3,     2,   -18,    48,   -88,   123,  -124,    58,
+      100,  -358,   687, -1017,  1234, -1148,   240, 13521,
+     4756, -2658,  1611,  -848,   293,    61,  -234,   268,
+     -219,   139,   -64,    14,    10,   -14,    10,    -4,
+        3,     1,   -17,    47,   -89,   126,  -131,    70,
+       85,  -342,   678, -1026,  1274, -1240,   430, 13597,
+     4509, -2608,  1617,  -874,   323,    36,  -217,   260,
+     -217,   140,   -67,    16,     8,   -13,     9,    -4,
+        4,     0,   -16,    46,   -89,   128,  -138,    82,
+       69,  -326,   669, -1033,  1312, -1331,   626, 13666,
+     4258, -2554,  1620,  -898,   352,    11,  -201,   252,
+     -215,   142,   -69,    18,     7,   -13,     9,    -4,
+        4,     0,   -15,    45,   -89,   131,  -144,    94,
+       53,  -310,   658, -1039,  1348, -1421,   826, 13726,
+     4012, -2497,  1620,  -921,   380,   -13,  -184,   243,
+     -213,   143,   -72,    21,     5,   -12,     9,    -4,
+        4,    -1,   -13,    44,   -89,   133,  -151,   105,
+       37,  -292,   646, -1042,  1383, -1510,  1030, 13779,
+     3766, -2437,  1618,  -942,   407,   -37,  -167,   234,
+     -210,   143,   -74,    23,     3,   -11,     8,    -3,
+        5,    -2,   -12,    43,   -88,   135,  -157,   117,
+       21,  -274,   632, -1044,  1415, -1598,  1239, 13823,
+     3520, -2373,  1612,  -960,   433,   -61,  -150,   224,
+     -206,   144,   -76,    25,     2,   -10,     8,    -3,
+        5,    -3,   -11,    42,   -88,   137,  -163,   128,
+        4,  -255,   618, -1044,  1445, -1684,  1451, 13860,
+     3278, -2306,  1604,  -977,   458,   -84,  -133,   215,
+     -203,   144,   -78,    28,     0,    -9,     8,    -3,
+        5,    -4,   -10,    40,   -87,   139,  -169,   140,
+      -13,  -236,   602, -1042,  1474, -1769,  1668, 13888,
+     3040, -2237,  1593,  -992,   482,  -107,  -116,   205,
+     -199,   144,   -80,    30,    -1,    -8,     7,    -3,
+        6,    -4,    -8,    39,   -86,   141,  -175,   151,
+      -30,  -216,   585, -1039,  1500, -1852,  1889, 13909,
+     2801, -2165,  1579, -1005,   505,  -130,   -98,   194,
+     -194,   144,   -82,    32,    -3,    -8,     7,    -3,
+        6,    -5,    -7,    37,   -86,   142,  -180,   162,
+      -47,  -195,   567, -1033,  1523, -1933,  2112, 13921,
+     2570, -2090,  1563, -1017,   526,  -152,   -81,   184,
+     -190,   144,   -83,    33,    -4,    -7,     7,    -3
+};
+
+#endif /* POLYPHASE_FILTER_BANK_H__ */
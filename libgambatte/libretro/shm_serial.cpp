@@ -0,0 +1,229 @@
+#include "shm_serial.h"
+#include "libretro.h"
+#include "gambatte_log.h"
+#include <new>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Same frames as NetSerial: a request is data | fastCgb << 8, a reply is
+// data | reply_marker << 8.
+enum { reply_marker = 128 };
+
+enum { ring_frames = 256 };
+
+enum { shm_magic = 0x47424C4B };
+
+// Both processes map this; the rings are single-producer single-consumer,
+// one per direction, and the builtins behind them work across processes.
+struct ShmSerial::Region {
+	unsigned magic;
+	unsigned attached[2];             // server, client
+	LinkChannel<ring_frames> ring[2]; // server to client, client to server
+};
+
+ShmSerial::ShmSerial()
+: is_stopped_(true)
+, is_server_(false)
+, name_()
+, region_(0)
+, lastAttachAttempt_(0)
+{
+}
+
+ShmSerial::~ShmSerial()
+{
+	stop();
+}
+
+bool ShmSerial::start(bool is_server, const std::string& name)
+{
+	stop();
+
+	gambatte_log(RETRO_LOG_INFO, "Starting GameLink shared memory %s on %s\n",
+			is_server ? "server" : "client", name.c_str());
+	is_server_ = is_server;
+	name_ = name;
+	lastAttachAttempt_ = 0;
+
+	if (is_server_) {
+		if (!create())
+			return false;
+	} else {
+		// The server may well not be up yet; connected() keeps trying.
+		attach();
+	}
+	is_stopped_ = false;
+	return true;
+}
+
+void ShmSerial::stop()
+{
+	if (!is_stopped_) {
+		gambatte_log(RETRO_LOG_INFO, "Stopping GameLink shared memory\n");
+		is_stopped_ = true;
+		detach();
+		if (is_server_)
+			shm_unlink(name_.c_str());
+	}
+}
+
+bool ShmSerial::create()
+{
+	// A server that died leaves its object behind; start afresh.
+	shm_unlink(name_.c_str());
+
+	int const fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		gambatte_log(RETRO_LOG_ERROR, "Error creating shared memory: %s\n", strerror(errno));
+		return false;
+	}
+	if (ftruncate(fd, sizeof(Region)) < 0) {
+		gambatte_log(RETRO_LOG_ERROR, "Error sizing shared memory: %s\n", strerror(errno));
+		close(fd);
+		shm_unlink(name_.c_str());
+		return false;
+	}
+
+	void* const p = mmap(NULL, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		gambatte_log(RETRO_LOG_ERROR, "Error mapping shared memory: %s\n", strerror(errno));
+		shm_unlink(name_.c_str());
+		return false;
+	}
+
+	region_ = new (p) Region;
+	region_->attached[0] = 0;
+	region_->attached[1] = 0;
+	link_store(&region_->attached[0], 1);
+	link_store(&region_->magic, shm_magic);
+	gambatte_log(RETRO_LOG_INFO, "GameLink shared memory server started!\n");
+	return true;
+}
+
+bool ShmSerial::attach()
+{
+	lastAttachAttempt_ = time(NULL);
+
+	int const fd = shm_open(name_.c_str(), O_RDWR, 0);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(Region))) {
+		close(fd);
+		return false;
+	}
+
+	void* const p = mmap(NULL, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		gambatte_log(RETRO_LOG_ERROR, "Error mapping shared memory: %s\n", strerror(errno));
+		return false;
+	}
+
+	Region* const region = static_cast<Region*>(p);
+	if (link_load(&region->magic) != shm_magic || !link_load(&region->attached[0])) {
+		munmap(p, sizeof(Region));
+		return false;
+	}
+
+	// Whatever the server sent a previous client is of no use to this one.
+	unsigned frame;
+	while (region->ring[0].pop(frame)) {}
+
+	region_ = region;
+	link_store(&region_->attached[1], 1);
+	gambatte_log(RETRO_LOG_INFO, "GameLink shared memory client connected to server!\n");
+	return true;
+}
+
+void ShmSerial::detach()
+{
+	if (region_) {
+		link_store(&region_->attached[is_server_ ? 0 : 1], 0);
+		munmap(region_, sizeof(Region));
+		region_ = 0;
+	}
+}
+
+bool ShmSerial::connected()
+{
+	if (is_stopped_) {
+		return false;
+	}
+	if (!region_) {
+		// Only attach attempts cost a syscall, so they are throttled.
+		if (is_server_ || time(NULL) - lastAttachAttempt_ < 1 || !attach())
+			return false;
+	}
+	if (!link_load(&region_->attached[is_server_ ? 1 : 0])) {
+		// A server that went away took its object with it; look for
+		// the next one.
+		if (!is_server_)
+			detach();
+		return false;
+	}
+	return true;
+}
+
+unsigned char ShmSerial::send(unsigned char data, bool fastCgb)
+{
+	if (!connected()) {
+		return 0xFF;
+	}
+
+	LinkChannel<ring_frames>& tx = region_->ring[is_server_ ? 0 : 1];
+	LinkChannel<ring_frames>& rx = region_->ring[is_server_ ? 1 : 0];
+	unsigned const& peer = region_->attached[is_server_ ? 1 : 0];
+
+	if (!tx.push(data | (fastCgb ? 1 : 0) << 8)) {
+		return 0xFF;
+	}
+
+	// The peer takes the byte whenever it gets to it, so wait for its answer
+	// for as long as it stays attached rather than making one up.
+	unsigned spins = 0;
+	for (;;) {
+		unsigned frame;
+		if (rx.pop(frame))
+			return frame & 0xFF;
+		if (!link_load(&peer))
+			return 0xFF;
+		if (++spins > 1000)
+			link_relax(spins);
+	}
+}
+
+bool ShmSerial::check(unsigned char out, unsigned char& in, bool& fastCgb)
+{
+	if (!connected()) {
+		return false;
+	}
+
+	LinkChannel<ring_frames>& tx = region_->ring[is_server_ ? 0 : 1];
+	LinkChannel<ring_frames>& rx = region_->ring[is_server_ ? 1 : 0];
+	unsigned const& peer = region_->attached[is_server_ ? 1 : 0];
+	unsigned frame;
+
+	while (rx.pop(frame)) {
+		// No request of ours is waiting on a reply here.
+		if ((frame >> 8) == reply_marker)
+			continue;
+
+		in = frame & 0xFF;
+		fastCgb = (frame >> 8) != 0;
+
+		unsigned spins = 0;
+		while (!tx.push(out | reply_marker << 8) && link_load(&peer))
+			link_relax(spins);
+		return true;
+	}
+
+	return false;
+}
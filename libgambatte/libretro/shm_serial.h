@@ -0,0 +1,41 @@
+#ifndef _SHM_SERIAL_H
+#define _SHM_SERIAL_H
+
+#include <gambatte.h>
+#include <string>
+#include <time.h>
+#include "link_sync.h"
+
+// GameLink between two processes on the same host through a pair of rings in
+// a POSIX shared memory object. There is no I/O thread: each side pushes to
+// and pops from the rings directly, so a transfer only enters the kernel when
+// the peer is slow to answer. The server creates the object, the client
+// attaches to it by name.
+class ShmSerial : public gambatte::SerialIO
+{
+	public:
+		ShmSerial();
+		~ShmSerial();
+
+		bool start(bool is_server, const std::string& name);
+		void stop();
+
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
+		virtual unsigned char send(unsigned char data, bool fastCgb);
+
+	private:
+		struct Region;
+
+		bool create();
+		bool attach();
+		void detach();
+		bool connected();
+
+		bool is_stopped_;
+		bool is_server_;
+		std::string name_;
+		Region* region_;
+		time_t lastAttachAttempt_;
+};
+
+#endif
@@ -497,7 +497,7 @@ void CPU::loadState(SaveState const &state) {
 
 void CPU::process(unsigned long const cycles) {
 	mem_.setEndtime(cycleCounter_, cycles);
-	mem_.updateInput();
+	mem_.sampleInput();
 
 	unsigned char a = a_;
 	unsigned long cycleCounter = cycleCounter_;
@@ -505,10 +505,6 @@ void CPU::process(unsigned long const cycles) {
 	while (mem_.isActive()) {
 		unsigned short pc = pc_;
 
-#ifdef HAVE_NETWORK
-		mem_.checkSerial(cycleCounter);
-#endif
-
 		if (mem_.halted()) {
 			if (cycleCounter < mem_.nextEventTime()) {
 				unsigned long cycles = mem_.nextEventTime() - cycleCounter;
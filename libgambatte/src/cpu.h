@@ -65,12 +65,36 @@ public:
 	void setInputGetter(InputGetter *getInput) {
 		mem_.setInputGetter(getInput);
 	}
+
+	void setLazyInput(bool enable) {
+		mem_.setLazyInput(enable);
+	}
+
+	void setSilent(bool silent) {
+		mem_.setSilent(silent);
+	}
+
+	void setSoundSink(SoundSink *sink) {
+		mem_.setSoundSink(sink);
+	}
+
+	void setSoundStems(uint_least32_t *const *stems) {
+		mem_.setSoundStems(stems);
+	}
 #ifdef HAVE_NETWORK
 	void setSerialIO(SerialIO *serial_io) {
-		mem_.setSerialIO(serial_io);
+		mem_.setSerialIO(serial_io, cycleCounter_);
+	}
+
+	void setSerialPollPeriod(unsigned cycles) {
+		mem_.setSerialPollPeriod(cycles);
 	}
 #endif
 
+	void setEmulatedRtc(bool enable) {
+		mem_.setEmulatedRtc(enable, cycleCounter_);
+	}
+
 	void setSaveDir(std::string const &sdir) {
 		mem_.setSaveDir(sdir);
 	}
@@ -88,6 +112,7 @@ public:
 #endif
 	void setSoundBuffer(uint_least32_t *buf, std::size_t size) { mem_.setSoundBuffer(buf, size); }
 	std::size_t fillSoundBuffer() { return mem_.fillSoundBuffer(cycleCounter_); }
+	bool soundIsFlat(uint_least32_t &level) const { return mem_.soundIsFlat(level); }
 	bool isCgb() const { return mem_.isCgb(); }
 
 	void setDmgPaletteColor(int palNum, int colorNum, unsigned long rgb32) {
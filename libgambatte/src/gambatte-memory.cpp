@@ -34,8 +34,11 @@ Memory::Memory(Interrupter const &interrupter) :
    getInput_(0)
 #ifdef HAVE_NETWORK
 , serial_io_(0)
+, serialPollPeriod_(256)
 #endif
 , divLastUpdate_(0)
+, emuTimeBase_(0)
+, emuTimeCc_(0)
 , lastOamDmaUpdate_(disabled_time)
 , lcd_(ioamhram_, 0, VideoInterruptRequester(intreq_))
 , interrupter_(interrupter)
@@ -44,6 +47,7 @@ Memory::Memory(Interrupter const &interrupter) :
 , oamDmaPos_(0xFE)
 , serialCnt_(0)
 , blanklcd_(false)
+, lazyInput_(false)
 , sachenLockCounter_(0)
 {
 	intreq_.setEventTime<intevent_blit>(144 * 456ul);
@@ -77,10 +81,10 @@ unsigned long Memory::saveState(SaveState &state, unsigned long cc) {
 #endif
 
 	intreq_.saveState(state);
-	cart_.saveState(state);
+	cart_.saveState(state, emulatedTime(cc));
 	tima_.saveState(state);
 	lcd_.saveState(state);
-	psg_.saveState(state);
+	psg_.saveState(state, cc);
 
 	return cc;
 }
@@ -93,10 +97,11 @@ void Memory::loadState(SaveState const &state) {
 	psg_.loadState(state);
 	lcd_.loadState(state, state.mem.oamDmaPos < 0xA0 ? cart_.rdisabledRam() : ioamhram_);
 	tima_.loadState(state, TimaInterruptRequester(intreq_));
-	cart_.loadState(state);
 	intreq_.loadState(state);
 
 	divLastUpdate_ = state.mem.divLastUpdate;
+	emuTimeCc_ = state.cpu.cycleCounter;
+	cart_.loadState(state, emuTimeBase_);
 	intreq_.setEventTime<intevent_serial>(state.mem.nextSerialtime > state.cpu.cycleCounter
 		? state.mem.nextSerialtime
 		: state.cpu.cycleCounter);
@@ -108,6 +113,7 @@ void Memory::loadState(SaveState const &state) {
 #ifdef HAVE_NETWORK
 	serialize_value_ = state.mem.serialize_value;
 	serialize_is_fastcgb_ = state.mem.serialize_is_fastcgb;
+	scheduleSerialPoll(state.cpu.cycleCounter);
 #endif
 	serialCnt_ = intreq_.eventTime(intevent_serial) != disabled_time
 	           ? serialCntFrom(intreq_.eventTime(intevent_serial) - state.cpu.cycleCounter,
@@ -169,11 +175,21 @@ void Memory::checkSerial(unsigned long const cc) {
 		 (intreq_.eventTime(intevent_serial) == disabled_time)) {
 		unsigned char data;
 		bool fastCgb;
-		if (serial_io_->check(ioamhram_[0x101], data, fastCgb)) {
+		if (serial_io_->check(ioamhram_[0x101], data, fastCgb, emulatedTime(cc))) {
 			startSerialTransfer(cc, data, fastCgb);
 		}
 	}
 }
+
+void Memory::scheduleSerialPoll(unsigned long const cc) {
+	// Only a game waiting for the other side to clock a transfer can receive anything.
+	bool const waiting = serial_io_ != 0
+	                  && (ioamhram_[0x102] & 0x81) == 0x80
+	                  && intreq_.eventTime(intevent_serial) == disabled_time;
+	intreq_.setEventTime<intevent_serialpoll>(waiting
+		? cc + (static_cast<unsigned long>(serialPollPeriod_) << isDoubleSpeed())
+		: static_cast<unsigned long>(disabled_time));
+}
 #endif
 
 void Memory::updateSerial(unsigned long const cc) {
@@ -182,7 +198,7 @@ void Memory::updateSerial(unsigned long const cc) {
 #ifdef HAVE_NETWORK
 			bool fire = ((ioamhram_[0x102] & 0x80) == 0x80);
 			ioamhram_[0x101] = ((ioamhram_[0x101] << serialCnt_) |
-					    (serialize_value_ >> (8 - serialCnt_))) & 0xFF;
+					    (serialize_value_ & ((1 << serialCnt_) - 1))) & 0xFF;
 #else
          ioamhram_[0x101] = (((ioamhram_[0x101] + 1) << serialCnt_) - 1) & 0xFF;
 #endif
@@ -199,8 +215,9 @@ void Memory::updateSerial(unsigned long const cc) {
 			int const targetCnt = serialCntFrom(intreq_.eventTime(intevent_serial) - cc,
 #ifdef HAVE_NETWORK
 			                                    serialize_is_fastcgb_);
+			// bits still to come stay in the low end of serialize_value_
 			ioamhram_[0x101] = ((ioamhram_[0x101] << (serialCnt_ - targetCnt)) |
-					    (serialize_value_ >> (8 - (serialCnt_ - targetCnt)))) & 0xFF;
+					    ((serialize_value_ >> targetCnt) & ((1 << (serialCnt_ - targetCnt)) - 1))) & 0xFF;
 #else
                                              ioamhram_[0x102] & isCgb() * 2);
          ioamhram_[0x101] = (((ioamhram_[0x101] + 1) << (serialCnt_ - targetCnt)) - 1) & 0xFF;
@@ -208,10 +225,6 @@ void Memory::updateSerial(unsigned long const cc) {
 			serialCnt_ = targetCnt;
 		}
 	}
-
-#ifdef HAVE_NETWORK
-	checkSerial(cc);
-#endif
 }
 
 void Memory::updateTimaIrq(unsigned long cc) {
@@ -270,6 +283,14 @@ unsigned long Memory::event(unsigned long cc) {
 	case intevent_serial:
 		updateSerial(cc);
 		break;
+	case intevent_serialpoll:
+#ifdef HAVE_NETWORK
+		checkSerial(cc);
+		scheduleSerialPoll(cc);
+#else
+		intreq_.setEventTime<intevent_serialpoll>(disabled_time);
+#endif
+		break;
 	case intevent_oam:
 		intreq_.setEventTime<intevent_oam>(lastOamDmaUpdate_ == disabled_time
 			? static_cast<unsigned long>(disabled_time)
@@ -384,6 +405,7 @@ unsigned long Memory::stop(unsigned long cc) {
 
    if (ioamhram_[0x14D] & isCgb())
    {
+      updateEmulatedTime(cc);
       psg_.generateSamples(cc, is_doublespeed);
       lcd_.speedChange(cc);
       ioamhram_[0x14D] ^= 0x81;
@@ -403,6 +425,13 @@ unsigned long Memory::stop(unsigned long cc) {
 	return cc;
 }
 
+void Memory::updateEmulatedTime(unsigned long const cc) {
+	// only whole units are moved into the base, so no time is lost in double speed
+	unsigned long const inc = (cc - emuTimeCc_) >> isDoubleSpeed();
+	emuTimeBase_ += inc;
+	emuTimeCc_ += inc << isDoubleSpeed();
+}
+
 static void decCycles(unsigned long &counter, unsigned long dec) {
 	if (counter != disabled_time)
 		counter -= dec;
@@ -428,9 +457,13 @@ unsigned long Memory::resetCounters(unsigned long cc) {
 	unsigned long const dec = cc < 0x10000
 	                        ? 0
 	                        : (cc & ~0x7FFFul) - 0x8000;
+	updateEmulatedTime(cc);
+	cart_.updateClock(emuTimeBase_);
+	emuTimeCc_ -= dec;
 	decCycles(divLastUpdate_, dec);
 	decCycles(lastOamDmaUpdate_, dec);
 	decEventCycles(intevent_serial, dec);
+	decEventCycles(intevent_serialpoll, dec);
 	decEventCycles(intevent_oam, dec);
 	decEventCycles(intevent_blit, dec);
 	decEventCycles(intevent_end, dec);
@@ -687,13 +720,19 @@ void Memory::nontrivial_ff_write(unsigned const p, unsigned data, unsigned long
 		serialCnt_ = 8;
 
 #ifdef HAVE_NETWORK
+		if (serial_io_ != 0 && (data & 0x81) != 0x80)
+			serial_io_->disarm(emulatedTime(cc));
 		if ((data & 0x81) == 0x81)
       {
 			unsigned char receivedByte = 0xFF;
 			if (serial_io_ != 0)
-				receivedByte = serial_io_->send(ioamhram_[0x101], (data & isCgb() * 2));
+				receivedByte = serial_io_->send(ioamhram_[0x101], (data & isCgb() * 2), emulatedTime(cc));
 			startSerialTransfer(cc, receivedByte, (data & isCgb() * 2));
       }
+		// first look for incoming data right away, then every serialPollPeriod_
+		intreq_.setEventTime<intevent_serialpoll>(serial_io_ != 0 && (data & 0x81) == 0x80
+			? cc
+			: static_cast<unsigned long>(disabled_time));
 #else
 		if ((data & 0x81) == 0x81)
       {
@@ -1149,7 +1188,7 @@ void Memory::nontrivial_write(unsigned const p, unsigned const data, unsigned lo
 	if (p < 0xFE00) {
 		if (p < 0xA000) {
 			if (p < 0x8000) {
-				cart_.mbcWrite(p, data);
+				cart_.mbcWrite(p, data, emulatedTime(cc));
 			} else if (lcd_.vramAccessible(cc)) {
 				lcd_.vramChange(cc);
 				cart_.vrambankptr()[p] = data;
@@ -1158,9 +1197,9 @@ void Memory::nontrivial_write(unsigned const p, unsigned const data, unsigned lo
 			if (cart_.wsrambankptr())
 				cart_.wsrambankptr()[p] = data;
 			else if (cart_.isHuC3())
-				cart_.HuC3Write(p, data);
+				cart_.HuC3Write(p, data, emulatedTime(cc));
 			else
-				cart_.rtcWrite(data);
+				cart_.rtcWrite(data, emulatedTime(cc));
 		} else
 			cart_.wramdata(p >> 12 & 1)[p & 0xFFF] = data;
 	} else if (p - 0xFF80u >= 0x7Fu) {
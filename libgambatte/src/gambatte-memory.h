@@ -135,13 +135,23 @@ public:
 	unsigned long event(unsigned long cycleCounter);
 	unsigned long resetCounters(unsigned long cycleCounter);
 	void setSaveDir(std::string const &dir) { cart_.setSaveDir(dir); }
+	void setEmulatedRtc(bool enable, unsigned long cc) { cart_.setEmulatedClock(enable, emulatedTime(cc)); }
 	void setInputGetter(InputGetter *getInput) { getInput_ = getInput; }
+	void setLazyInput(bool enable) { lazyInput_ = enable; }
+	void setSilent(bool silent) { psg_.setSilent(silent); }
+	void setSoundSink(SoundSink *sink) { psg_.setSink(sink); }
+	void setSoundStems(uint_least32_t *const *stems) { psg_.setStems(stems); }
 #ifdef HAVE_NETWORK
-	void setSerialIO(SerialIO* serial_io) { serial_io_ = serial_io; }
+	void setSerialIO(SerialIO* serial_io, unsigned long cc) {
+		serial_io_ = serial_io;
+		scheduleSerialPoll(cc);
+	}
+	void setSerialPollPeriod(unsigned cycles) { serialPollPeriod_ = cycles ? cycles : 1; }
 #endif
 	void setEndtime(unsigned long cc, unsigned long inc);
 	void setSoundBuffer(uint_least32_t *buf, std::size_t size) { psg_.setBuffer(buf, size); }
 	std::size_t fillSoundBuffer(unsigned long cc);
+	bool soundIsFlat(uint_least32_t &level) const { return psg_.isFlat(level); }
 
 	void setVideoBuffer(video_pixel_t *videoBuf, std::ptrdiff_t pitch) {
 		lcd_.setVideoBuffer(videoBuf, pitch);
@@ -153,11 +163,22 @@ public:
 
 	void setGameGenie(std::string const &codes) { cart_.setGameGenie(codes); }
 	void setGameShark(std::string const &codes) { interrupter_.setGameShark(codes); }
-#ifdef HAVE_NETWORK
-	void checkSerial(unsigned long cc);
-#endif
 	void updateInput();
 
+	// Called at the start of every CPU::process. Lazy input leaves sampling to
+	// the FF00 accesses, unless the joypad interrupt is enabled: a game waiting
+	// for it never reads FF00 until a button is down.
+	void sampleInput() {
+		if (!lazyInput_ || (intreq_.iereg() & 0x10))
+			updateInput();
+	}
+
+	// Emulated time in 4194304 Hz units since power-on. Unlike cycle counter values
+	// it is not affected by double speed mode or by resetCounters.
+	unsigned long emulatedTime(unsigned long cc) const {
+		return emuTimeBase_ + ((cc - emuTimeCc_) >> isDoubleSpeed());
+	}
+
    int loadROM(const void *romdata, unsigned int romsize, unsigned int forceModel, const bool multicartCompat);
 
    /* Forwarders for unlicensed-mapper hooks. Currently only Sachen
@@ -190,9 +211,12 @@ private:
 	unsigned char serialize_value_;
 	bool serialize_is_fastcgb_;
 	SerialIO *serial_io_;
+	unsigned serialPollPeriod_;
 #endif
 	InputGetter *getInput_;
 	unsigned long divLastUpdate_;
+	unsigned long emuTimeBase_;
+	unsigned long emuTimeCc_;
 	unsigned long lastOamDmaUpdate_;
 	InterruptRequester intreq_;
 	Tima tima_;
@@ -204,6 +228,7 @@ private:
 	unsigned char oamDmaPos_;
 	unsigned char serialCnt_;
 	bool blanklcd_;
+	bool lazyInput_;
 
 	void decEventCycles(IntEventId eventId, unsigned long dec);
 	void oamDmaInitSetup();
@@ -216,8 +241,13 @@ private:
 	void nontrivial_ff_write(unsigned p, unsigned data, unsigned long cycleCounter);
 	void nontrivial_write(unsigned p, unsigned data, unsigned long cycleCounter);
 	void updateSerial(unsigned long cc);
+#ifdef HAVE_NETWORK
+	void checkSerial(unsigned long cc);
+	void scheduleSerialPoll(unsigned long cc);
+#endif
 	void updateTimaIrq(unsigned long cc);
 	void updateIrqs(unsigned long cc);
+	void updateEmulatedTime(unsigned long cc);
 	bool isDoubleSpeed() const { return lcd_.isDoubleSpeed(); }
 };
 
@@ -23,15 +23,68 @@
 #include "initstate.h"
 #include "bootloader.h"
 #include <sstream>
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace gambatte {
+
+namespace {
+
+// The arrays a SaveState points to rather than holds. A snapshot is the
+// SaveState followed by these, in this order.
+struct StateBlock {
+	void *data;
+	std::size_t size;
+};
+
+enum { num_state_blocks = 9 };
+
+template<class T>
+StateBlock stateBlock(SaveState::Ptr<T> const &p) {
+	StateBlock const b = { p.get(), p.size() * sizeof(T) };
+	return b;
+}
+
+void getStateBlocks(SaveState const &state, StateBlock (&blocks)[num_state_blocks]) {
+	blocks[0] = stateBlock(state.mem.vram);
+	blocks[1] = stateBlock(state.mem.sram);
+	blocks[2] = stateBlock(state.mem.wram);
+	blocks[3] = stateBlock(state.mem.ioamhram);
+	blocks[4] = stateBlock(state.ppu.bgpData);
+	blocks[5] = stateBlock(state.ppu.objpData);
+	blocks[6] = stateBlock(state.ppu.oamReaderBuf);
+	blocks[7] = stateBlock(state.ppu.oamReaderSzbuf);
+	blocks[8] = stateBlock(state.spu.ch3.waveRam);
+}
+
+class FixedInput : public InputGetter {
+public:
+	FixedInput() : mask(0) {}
+	virtual unsigned operator()() { return mask; }
+
+	unsigned mask;
+};
+
+enum { step_frame_samples = 35112, step_sound_buf_size = step_frame_samples + 2064 };
+
+}
+
 struct GB::Priv {
 	CPU cpu;
+	InputGetter *getInput;
+	FixedInput stepInput;
+	std::vector<video_pixel_t> stepVideoBuf;
+	std::vector<uint_least32_t> stepSoundBuf;
 	int stateNo;
 	bool gbaCgbMode;
+	SoundSink *soundSink;
+	uint_least32_t *soundStems[4];
+	bool silent;
 	
-	Priv() : stateNo(1), gbaCgbMode(false) {}
+	Priv() : getInput(0), stateNo(1), gbaCgbMode(false), soundSink(0), silent(false) {
+		std::fill(soundStems, soundStems + 4, static_cast<uint_least32_t *>(0));
+	}
 
    void full_init(bool clearSram = true);
 };
@@ -52,6 +105,88 @@ long GB::runFor(gambatte::video_pixel_t *const videoBuf, const int pitch,
 	
 	return cyclesSinceBlit < 0 ? cyclesSinceBlit : static_cast<long>(samples) - (cyclesSinceBlit >> 1);
 }
+
+std::size_t GB::obsSize(unsigned const obsFlags) {
+	return (obsFlags & OBS_WRAM ? 0x2000 : 0)
+	     + (obsFlags & OBS_HRAM ? 0x80 : 0)
+	     + (obsFlags & OBS_OAM  ? 0xA0 : 0)
+	     + (obsFlags & OBS_SCREEN
+	        ? OBS_SCREEN_WIDTH * OBS_SCREEN_HEIGHT * sizeof(video_pixel_t)
+	        : 0);
+}
+
+std::size_t GB::step(unsigned const inputMask, unsigned const frames, unsigned const obsFlags,
+		void *const obsBuf, uint_least32_t *const soundBuf, std::size_t const soundBufSize) {
+	std::size_t written = 0;
+
+	p_->stepInput.mask = inputMask;
+	p_->cpu.setInputGetter(&p_->stepInput);
+	p_->cpu.setSilent(p_->silent || !soundBuf);
+	p_->cpu.setSoundSink(0);
+	p_->cpu.setSoundStems(0);
+	p_->stepSoundBuf.resize(step_sound_buf_size);
+	if (obsFlags & OBS_SCREEN)
+		p_->stepVideoBuf.resize(160 * 144);
+
+	for (unsigned n = 0; n < frames; ++n) {
+		video_pixel_t *const videoBuf = n + 1 == frames && (obsFlags & OBS_SCREEN)
+		                              ? &p_->stepVideoBuf[0]
+		                              : 0;
+		long cyclesSinceBlit;
+
+		p_->cpu.setVideoBuffer(videoBuf, 160);
+
+		do {
+			p_->cpu.setSoundBuffer(&p_->stepSoundBuf[0], step_sound_buf_size);
+			cyclesSinceBlit = p_->cpu.runFor(step_frame_samples * 2);
+
+			std::size_t samples = p_->cpu.fillSoundBuffer();
+			if (soundBuf && !p_->silent) {
+				samples = std::min(samples, soundBufSize - written);
+				std::memcpy(soundBuf + written, &p_->stepSoundBuf[0], samples * sizeof *soundBuf);
+				written += samples;
+			}
+		} while (cyclesSinceBlit < 0);
+	}
+
+	p_->cpu.setInputGetter(p_->getInput);
+	p_->cpu.setSilent(p_->silent);
+	p_->cpu.setSoundSink(p_->soundSink);
+	p_->cpu.setSoundStems(p_->soundStems[0] ? p_->soundStems : 0);
+
+	unsigned char *obs = static_cast<unsigned char *>(obsBuf);
+
+	if (obsFlags & OBS_WRAM) {
+		std::memcpy(obs, p_->cpu.rambank0_ptr(), 0x2000);
+		obs += 0x2000;
+	}
+
+	if (obsFlags & OBS_HRAM) {
+		std::memcpy(obs, p_->cpu.zeropage_ptr(), 0x80);
+		obs += 0x80;
+	}
+
+	if (obsFlags & OBS_OAM) {
+		std::memcpy(obs, p_->cpu.oamram_ptr(), 0xA0);
+		obs += 0xA0;
+	}
+
+	if (obsFlags & OBS_SCREEN) {
+		video_pixel_t line[OBS_SCREEN_WIDTH];
+
+		for (unsigned y = 0; y < OBS_SCREEN_HEIGHT; ++y) {
+			video_pixel_t const *const src = &p_->stepVideoBuf[y * 2 * 160];
+
+			for (unsigned x = 0; x < OBS_SCREEN_WIDTH; ++x)
+				line[x] = src[x * 2];
+
+			std::memcpy(obs, line, sizeof line);
+			obs += sizeof line;
+		}
+	}
+
+	return written;
+}
    
 void GB::Priv::full_init(bool const clearSram) {
    SaveState state;
@@ -96,9 +231,38 @@ void GB::reset() {
 }
 
 void GB::setInputGetter(InputGetter *getInput) {
+	p_->getInput = getInput;
 	p_->cpu.setInputGetter(getInput);
 }
 
+void GB::setLazyInput(bool enable) {
+	p_->cpu.setLazyInput(enable);
+}
+
+void GB::setSilent(bool silent) {
+	p_->silent = silent;
+	p_->cpu.setSilent(silent);
+}
+
+bool GB::isSilent() const {
+	return p_->silent;
+}
+
+void GB::setSoundSink(SoundSink *sink) {
+	p_->soundSink = sink;
+	p_->cpu.setSoundSink(sink);
+}
+
+void GB::setSoundStems(uint_least32_t *const *stems) {
+	for (int i = 0; i < 4; ++i)
+		p_->soundStems[i] = stems ? stems[i] : 0;
+	p_->cpu.setSoundStems(stems);
+}
+
+bool GB::soundIsFlat(uint_least32_t &level) const {
+	return p_->cpu.soundIsFlat(level);
+}
+
 void GB::setBootloaderGetter(bool (*getter)(void* userdata, bool isgbc, uint8_t* data, uint32_t max_size)) {
    p_->cpu.mem_.bootloader.set_bootloader_getter(getter);
 }
@@ -107,8 +271,16 @@ void GB::setBootloaderGetter(bool (*getter)(void* userdata, bool isgbc, uint8_t*
 void GB::setSerialIO(SerialIO *serial_io) {
 	p_->cpu.setSerialIO(serial_io);
 }
+
+void GB::setSerialPollPeriod(unsigned cycles) {
+	p_->cpu.setSerialPollPeriod(cycles);
+}
 #endif
 
+void GB::setEmulatedRtc(bool enable) {
+	p_->cpu.setEmulatedRtc(enable);
+}
+
 void *GB::savedata_ptr() { return p_->cpu.savedata_ptr(); }
 unsigned GB::savedata_size() { return p_->cpu.savedata_size(); }
 void *GB::rtcdata_ptr() { return p_->cpu.rtcdata_ptr(); }
@@ -143,7 +315,8 @@ void GB::setDmgPaletteColor(unsigned palNum, unsigned colorNum, unsigned rgb32)
 }
 
 bool GB::loadState(const void *data, size_t size) {
-   SaveState state;
+   // anything older states do not have is left zero
+   SaveState state = SaveState();
    p_->cpu.setStatePtrs(state);
 
    if (StateSaver::loadState(state, data, size)) {
@@ -168,6 +341,55 @@ size_t GB::stateSize() const {
    return StateSaver::stateSize(state);
 }
 
+void GB::saveSnapshot(void *data) {
+	SaveState state;
+	p_->cpu.setStatePtrs(state);
+	p_->cpu.saveState(state);
+
+	char *out = static_cast<char *>(data);
+	std::memcpy(static_cast<void *>(out), &state, sizeof state);
+	out += sizeof state;
+
+	StateBlock blocks[num_state_blocks];
+	getStateBlocks(state, blocks);
+	for (int i = 0; i < num_state_blocks; ++i) {
+		std::memcpy(out, blocks[i].data, blocks[i].size);
+		out += blocks[i].size;
+	}
+}
+
+void GB::loadSnapshot(void const *data) {
+	char const *in = static_cast<char const *>(data);
+	SaveState state;
+	std::memcpy(static_cast<void *>(&state), in, sizeof state);
+	in += sizeof state;
+
+	// the pointers in there are ours already, but only if nothing was reloaded
+	p_->cpu.setStatePtrs(state);
+	StateBlock blocks[num_state_blocks];
+	getStateBlocks(state, blocks);
+	for (int i = 0; i < num_state_blocks; ++i) {
+		std::memcpy(blocks[i].data, in, blocks[i].size);
+		in += blocks[i].size;
+	}
+
+	p_->cpu.loadState(state);
+	p_->cpu.mem_.bootloader.choosebank(state.mem.ioamhram.get()[0x150] != 0xFF);
+}
+
+std::size_t GB::snapshotSize() const {
+	SaveState state;
+	p_->cpu.setStatePtrs(state);
+
+	StateBlock blocks[num_state_blocks];
+	getStateBlocks(state, blocks);
+	std::size_t size = sizeof state;
+	for (int i = 0; i < num_state_blocks; ++i)
+		size += blocks[i].size;
+
+	return size;
+}
+
 void GB::setColorCorrection(bool enable) {
    p_->cpu.mem_.display_setColorCorrection(enable);
 }
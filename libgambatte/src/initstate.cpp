@@ -1283,6 +1283,7 @@ void gambatte::setInitState(SaveState &state, bool const cgb, bool const gbaCgbM
 
 	// spu.cycleCounter >> 12 & 7 represents the frame sequencer position.
 	state.spu.cycleCounter = (cgb ? 0x1E00 : 0x2400) | (state.cpu.cycleCounter >> 1 & 0x1FF);
+	state.spu.lag = 0;
 
 	state.spu.ch1.sweep.counter = SoundUnit::counter_disabled;
 	state.spu.ch1.sweep.shadow = 0;
@@ -1355,4 +1356,7 @@ void gambatte::setInitState(SaveState &state, bool const cgb, bool const gbaCgbM
 	state.huc3.ramValue = 1;
 	state.huc3.modeflag = 2; // huc3_none
 	state.huc3.irReceivingPulse = false;
+
+	state.time.seconds = std::time(0);
+	state.time.ticks = 0;
 }
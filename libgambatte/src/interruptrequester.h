@@ -30,6 +30,7 @@ enum IntEventId { intevent_unhalt,
                   intevent_end,
                   intevent_blit,
                   intevent_serial,
+                  intevent_serialpoll,
                   intevent_oam,
                   intevent_dma,
                   intevent_tima,
@@ -43,6 +44,7 @@ public:
 	void loadState(SaveState const &);
 	void resetCc(unsigned long oldCc, unsigned long newCc);
 	unsigned ifreg() const { return ifreg_; }
+	unsigned iereg() const { return iereg_; }
 	unsigned pendingIrqs() const { return ifreg_ & iereg_; }
 	bool ime() const { return intFlags_.ime(); }
 	bool halted() const { return intFlags_.halted(); }
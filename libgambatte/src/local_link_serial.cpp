@@ -0,0 +1,98 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#include "local_link_serial.h"
+
+namespace gambatte {
+
+LocalLinkSerial::LocalLinkSerial() {
+	port_[0].peer = &port_[1];
+	port_[1].peer = &port_[0];
+}
+
+void LocalLinkSerial::reset() {
+	port_[0].reset();
+	port_[1].reset();
+}
+
+LocalLinkSerial::Port::Port()
+: peer(0)
+{
+	reset();
+}
+
+void LocalLinkSerial::Port::reset() {
+	time_ = 0;
+	inTime_ = 0;
+	out_ = 0xFF;
+	in_ = 0xFF;
+	inFast_ = false;
+	listening_ = false;
+	pending_ = false;
+}
+
+bool LocalLinkSerial::Port::check(unsigned char out, unsigned char& in, bool& fastCgb) {
+	return check(out, in, fastCgb, time_);
+}
+
+unsigned char LocalLinkSerial::Port::send(unsigned char data, bool fastCgb) {
+	return send(data, fastCgb, time_);
+}
+
+// Called while SC has the transfer bit set with the external clock selected,
+// so it doubles as the "armed with SB = out" notification for the peer.
+bool LocalLinkSerial::Port::check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time) {
+	time_ = time;
+	out_ = out;
+	listening_ = true;
+
+	if (pending_ && static_cast<long>(time - inTime_) >= 0) {
+		pending_ = false;
+		listening_ = false;
+		in = in_;
+		fastCgb = inFast_;
+		return true;
+	}
+
+	return false;
+}
+
+// A byte the peer clocked in while this side was still armed, but that has not
+// been picked up yet, is dropped along with the arming: the game went on without it.
+void LocalLinkSerial::Port::disarm(unsigned long time) {
+	time_ = time;
+	listening_ = false;
+	pending_ = false;
+}
+
+unsigned char LocalLinkSerial::Port::send(unsigned char data, bool fastCgb, unsigned long time) {
+	time_ = time;
+	listening_ = false;
+
+	// nobody shifting out on the other end, or its previous byte not clocked in yet
+	if (!peer->listening_ || peer->pending_)
+		return 0xFF;
+
+	peer->pending_ = true;
+	peer->listening_ = false;
+	peer->in_ = data;
+	peer->inFast_ = fastCgb;
+	peer->inTime_ = time;
+
+	return peer->out_;
+}
+
+}
@@ -0,0 +1,72 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef LOCAL_LINK_SERIAL_H
+#define LOCAL_LINK_SERIAL_H
+
+#include "serial_io.h"
+
+namespace gambatte {
+
+// Link cable between two GB instances in the same process. Attach port(0) to
+// one console and port(1) to the other with GB::setSerialIO, then advance both
+// alternately on one thread, e.g. a few scanlines' worth of samples each.
+//
+// Every exchange is stamped with the sender's emulated time. The receiving
+// console does not see a byte before its own clock reaches that time, and the
+// clocking side gets the byte the receiver last armed SB with. No host time,
+// threads or I/O are involved, so two runs that advance the consoles in the
+// same slices transfer exactly the same bytes at the same emulated times.
+class LocalLinkSerial
+{
+	public:
+		LocalLinkSerial();
+
+		SerialIO& port(unsigned n) { return port_[n & 1]; }
+		void reset();
+
+	private:
+		class Port : public SerialIO
+		{
+			public:
+				Port();
+
+				void reset();
+
+				virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
+				virtual unsigned char send(unsigned char data, bool fastCgb);
+				virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time);
+				virtual unsigned char send(unsigned char data, bool fastCgb, unsigned long time);
+				virtual void disarm(unsigned long time);
+
+				Port* peer;
+
+			private:
+				unsigned long time_;
+				unsigned long inTime_;
+				unsigned char out_;
+				unsigned char in_;
+				bool inFast_;
+				bool listening_;
+				bool pending_;
+		};
+
+		Port port_[2];
+};
+
+}
+
+#endif
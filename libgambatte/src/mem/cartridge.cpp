@@ -745,15 +745,17 @@ namespace gambatte
       state.mem.wram.set(memptrs_.wramdata(0), memptrs_.wramdataend() - memptrs_.wramdata(0));
    }
 
-   void Cartridge::saveState(SaveState &state) const
+   void Cartridge::saveState(SaveState &state, unsigned long time) const
    {
+      clock_.saveState(state, time);
       mbc->saveState(state.mem);
       rtc_.saveState(state);
       huc3_.saveState(state);
    }
 
-   void Cartridge::loadState(const SaveState &state)
+   void Cartridge::loadState(const SaveState &state, unsigned long time)
    {
+      clock_.loadState(state, time);
       huc3_.loadState(state);
       rtc_.loadState(state);
       mbc->loadState(state.mem);
@@ -22,6 +22,7 @@
 #include "memptrs.h"
 #include "rtc.h"
 #include "huc3.h"
+#include "rtc_clock.h"
 #include "savestate.h"
 #include <memory>
 #include <string>
@@ -55,10 +56,12 @@ namespace gambatte
    class Cartridge
    {
       public:
-         Cartridge() : isSachen_(false) {}
+         Cartridge() : rtc_(clock_), huc3_(clock_), isSachen_(false) {}
          void setStatePtrs(SaveState &);
-         void saveState(SaveState &) const;
-         void loadState(const SaveState &);
+         /* time is Memory::emulatedTime(), which drives the
+          * cartridge clock when it runs on emulated time. */
+         void saveState(SaveState &, unsigned long time) const;
+         void loadState(const SaveState &, unsigned long time);
 
          bool loaded() const { return mbc.get(); }
 
@@ -126,15 +129,20 @@ namespace gambatte
             memptrs_.setOamDmaSrc(oamDmaSrc);
          }
 
-         void mbcWrite(unsigned addr, unsigned data) { mbc->romWrite(addr, data); }
+         void mbcWrite(unsigned addr, unsigned data, unsigned long time)
+         {
+            clock_.update(time);
+            mbc->romWrite(addr, data);
+         }
 
          bool isCgb() const
          {
             return gambatte::isCgb(memptrs_);
          }
 
-         void rtcWrite(unsigned data)
+         void rtcWrite(unsigned data, unsigned long time)
          {
+            clock_.update(time);
             rtc_.write(data);
          }
 
@@ -151,7 +159,14 @@ namespace gambatte
 
          bool isHuC3() const { return huc3_.isHuC3(); }
          unsigned char HuC3Read(unsigned p, unsigned long const cc) { return huc3_.read(p, cc); }
-         void HuC3Write(unsigned p, unsigned data) { huc3_.write(p, data); }
+         void HuC3Write(unsigned p, unsigned data, unsigned long time)
+         {
+            clock_.update(time);
+            huc3_.write(p, data);
+         }
+
+         void updateClock(unsigned long time) { clock_.update(time); }
+         void setEmulatedClock(bool enable, unsigned long time) { clock_.setEmulated(enable, time); }
 
          /* Sachen MMC1 (unlicensed mapper used by Sachen 4-in-1 etc.):
           * the cartridge header is bit-scrambled and a "locked" boot
@@ -203,6 +218,7 @@ namespace gambatte
             }
          };
          MemPtrs memptrs_;
+         RtcClock clock_;
          Rtc rtc_;
          HuC3Chip huc3_;
          /* True only when the loaded ROM was identified as a Sachen
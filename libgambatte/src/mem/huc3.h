@@ -28,6 +28,7 @@ enum
 
 #include <ctime>
 #include <stdint.h>
+#include "rtc_clock.h"
 
 namespace gambatte {
 
@@ -35,7 +36,7 @@ struct SaveState;
 
 class HuC3Chip {
 public:
-	HuC3Chip();
+	explicit HuC3Chip(RtcClock const &clock);
 	uint64_t baseTime() const { return baseTime_; }
 	void setBaseTime(uint64_t baseTime) { baseTime_ = baseTime; }
 
@@ -57,6 +58,7 @@ public:
 	void write(unsigned p, unsigned data);
 
 private:
+	RtcClock const &clock_;
 	uint64_t baseTime_;
 	uint64_t haltTime_;
 	unsigned dataTime_;
@@ -21,6 +21,7 @@
 
 #include <ctime>
 #include <stdint.h>
+#include "rtc_clock.h"
 
 namespace gambatte
 {
@@ -30,7 +31,7 @@ namespace gambatte
    class Rtc
    {
       public:
-         Rtc();
+         explicit Rtc(const RtcClock &clock);
 
          const unsigned char* getActive() const
          {
@@ -76,6 +77,7 @@ namespace gambatte
          }
 
       private:
+         const RtcClock &clock_;
          unsigned char *activeData_;
          void (Rtc::*activeSet_)(unsigned);
          uint64_t baseTime_;
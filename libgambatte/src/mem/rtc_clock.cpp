@@ -0,0 +1,52 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#include "rtc_clock.h"
+#include "../savestate.h"
+
+namespace gambatte {
+
+void RtcClock::setEmulated(bool enable, unsigned long ticks) {
+	if (enable && !emulated_) {
+		seconds_ = std::time(0);
+		ticks_ = ticks;
+	}
+
+	emulated_ = enable;
+}
+
+void RtcClock::saveState(SaveState &state, unsigned long ticks) const {
+	// saved in either mode, so a state made with the host clock can be
+	// continued with the emulated one from where it was saved
+	if (emulated_) {
+		unsigned long const secs = (ticks - ticks_) / ticks_per_second;
+		state.time.seconds = seconds_ + secs;
+		state.time.ticks = ticks - ticks_ - secs * ticks_per_second;
+	} else {
+		state.time.seconds = std::time(0);
+		state.time.ticks = 0;
+	}
+}
+
+void RtcClock::loadState(SaveState const &state, unsigned long ticks) {
+	// zero for states saved before the clock was, which keep the current time
+	if (emulated_ && state.time.seconds) {
+		seconds_ = state.time.seconds;
+		ticks_ = ticks - state.time.ticks % ticks_per_second;
+	}
+}
+
+}
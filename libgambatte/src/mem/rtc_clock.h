@@ -0,0 +1,66 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef RTC_CLOCK_H
+#define RTC_CLOCK_H
+
+#include <ctime>
+#include <stdint.h>
+
+namespace gambatte {
+
+struct SaveState;
+
+// The time cartridge clocks (MBC3 RTC, HuC3) count from, in seconds since the
+// epoch. By default that is the host clock. In emulated mode it is seeded from
+// the host clock once and then only advances with emulated time, so
+// fast-forwarded, paused and headless runs all see the clock the game would
+// see on hardware running at the same pace, and no time syscall is made.
+//
+// Emulated time is passed in as Memory::emulatedTime() units (4194304 Hz).
+// Since it wraps, update() has to be called at least every 2^32 units or so;
+// Memory does it on every counter reset.
+class RtcClock {
+public:
+	enum { ticks_per_second = 4194304 };
+
+	RtcClock() : seconds_(0), ticks_(0), emulated_(false) {}
+
+	bool isEmulated() const { return emulated_; }
+	void setEmulated(bool enable, unsigned long ticks);
+
+	void update(unsigned long ticks) {
+		if (emulated_) {
+			unsigned long const secs = (ticks - ticks_) / ticks_per_second;
+			seconds_ += secs;
+			ticks_ += secs * ticks_per_second;
+		}
+	}
+
+	uint64_t now() const { return emulated_ ? seconds_ : uint64_t(std::time(0)); }
+
+	void saveState(SaveState &state, unsigned long ticks) const;
+	void loadState(SaveState const &state, unsigned long ticks);
+
+private:
+	uint64_t seconds_;
+	unsigned long ticks_; // emulated time at which seconds_ last ticked
+	bool emulated_;
+};
+
+}
+
+#endif
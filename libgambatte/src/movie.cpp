@@ -0,0 +1,140 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#include "movie.h"
+#include <algorithm>
+
+namespace {
+
+enum { movie_version = 1 };
+enum { flag_power_on = 1 };
+
+unsigned char const movie_tag[] = { 'G', 'B', 'M', 'V', movie_version };
+
+enum { flags_pos = sizeof movie_tag,
+       crc_pos = flags_pos + 1,
+       rom_size_pos = crc_pos + 4,
+       state_size_pos = rom_size_pos + 4,
+       state_pos = state_size_pos + 4 };
+
+unsigned long crc32(void const* data, std::size_t size) {
+	unsigned char const* p = static_cast<unsigned char const*>(data);
+	unsigned long crc = 0xFFFFFFFF;
+
+	while (size--) {
+		crc ^= *p++;
+		for (int i = 0; i < 8; ++i)
+			crc = crc >> 1 ^ (0xEDB88320 & (0 - (crc & 1)));
+	}
+
+	return ~crc & 0xFFFFFFFF;
+}
+
+void put32(std::vector<unsigned char>& v, unsigned long n) {
+	for (int i = 0; i < 4; ++i)
+		v.push_back(n >> (i * 8) & 0xFF);
+}
+
+unsigned long get32(unsigned char const* p) {
+	return p[0] | p[1] << 8 | static_cast<unsigned long>(p[2]) << 16
+	     | static_cast<unsigned long>(p[3]) << 24;
+}
+
+}
+
+namespace gambatte {
+
+MovieRecorder::MovieRecorder(InputGetter* inner)
+: inner_(inner)
+, input_(0)
+, polled_(false)
+{
+}
+
+void MovieRecorder::start(GB& gb, void const* rom, std::size_t romSize, bool powerOn) {
+	if (powerOn)
+		gb.reset();
+
+	std::size_t const stateSize = gb.stateSize();
+
+	movie_.assign(movie_tag, movie_tag + sizeof movie_tag);
+	movie_.push_back(powerOn ? flag_power_on : 0);
+	put32(movie_, crc32(rom, romSize));
+	put32(movie_, romSize);
+	put32(movie_, stateSize);
+	movie_.resize(state_pos + stateSize);
+	gb.saveState(&movie_[state_pos]);
+	// playback starts from a loaded state, so recording does too: not every
+	// bit of the console makes it through a savestate
+	gb.loadState(&movie_[state_pos], stateSize);
+
+	polled_ = false;
+}
+
+unsigned MovieRecorder::operator()() {
+	if (!polled_) {
+		input_ = inner_ ? (*inner_)() & 0xFF : 0;
+		polled_ = true;
+	}
+
+	return input_;
+}
+
+void MovieRecorder::endFrame() {
+	// a frame the game did not look at the input in still gets an entry,
+	// since playback goes by frames
+	movie_.push_back(polled_ ? input_ : 0);
+	polled_ = false;
+}
+
+MoviePlayer::MoviePlayer()
+: inputPos_(0)
+, pos_(0)
+{
+}
+
+bool MoviePlayer::load(void const* data, std::size_t size) {
+	unsigned char const* const p = static_cast<unsigned char const*>(data);
+	if (size < state_pos || !std::equal(movie_tag, movie_tag + sizeof movie_tag, p)
+			|| get32(p + state_size_pos) > size - state_pos)
+		return false;
+
+	movie_.assign(p, p + size);
+	inputPos_ = pos_ = state_pos + get32(p + state_size_pos);
+	return true;
+}
+
+bool MoviePlayer::start(GB& gb, void const* rom, std::size_t romSize) {
+	if (movie_.empty()
+			|| get32(&movie_[rom_size_pos]) != romSize
+			|| get32(&movie_[crc_pos]) != crc32(rom, romSize))
+		return false;
+
+	pos_ = inputPos_;
+	return gb.loadState(&movie_[state_pos], inputPos_ - state_pos);
+}
+
+unsigned MoviePlayer::operator()() {
+	// past the end, nothing is pressed
+	return done() ? 0 : movie_[pos_];
+}
+
+void MoviePlayer::endFrame() {
+	if (!done())
+		++pos_;
+}
+
+}
@@ -0,0 +1,92 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include "gambatte.h"
+#include "inputgetter.h"
+#include <cstddef>
+#include <vector>
+
+namespace gambatte {
+
+// Input movie format: a "GBMV" tag and a version byte, then
+//   flags      bit 0 set if the movie starts at power-on
+//   rom crc    CRC-32 of the ROM image, 4 bytes little endian
+//   rom size   4 bytes little endian
+//   state size 4 bytes little endian
+//   state      savestate the movie starts from
+//   input      one InputGetter button mask per frame
+// The start state is there even for power-on movies, taken right after the
+// reset, so that battery RAM and the cartridge clock start out the same too.
+// Games with a real-time clock only replay if it runs on emulated time.
+// Frames in the movie are counted between the video frames runFor returns,
+// so both recording and playback have to call endFrame after every one.
+
+// Sits between the console and the real input. Input is only taken once a
+// frame, the first time the game asks for it, and held for the rest of the
+// frame, which is all a movie has room for.
+class MovieRecorder : public InputGetter
+{
+	public:
+		explicit MovieRecorder(InputGetter* inner = 0);
+
+		void setInner(InputGetter* inner) { inner_ = inner; }
+		// Starts a new movie from the current state of gb, which is reset
+		// first for a power-on movie. rom is what gb was loaded from.
+		void start(GB& gb, void const* rom, std::size_t romSize, bool powerOn);
+		// Call after each frame gb has run, that is whenever runFor
+		// returns a frame.
+		void endFrame();
+		std::vector<unsigned char> const& movie() const { return movie_; }
+
+		virtual unsigned operator()();
+
+	private:
+		InputGetter* inner_;
+		std::vector<unsigned char> movie_;
+		unsigned input_;
+		bool polled_;
+};
+
+// Plays a movie back in place of the real input.
+class MoviePlayer : public InputGetter
+{
+	public:
+		MoviePlayer();
+
+		// Copies the movie. Fails on anything MovieRecorder did not write.
+		bool load(void const* data, std::size_t size);
+		// Puts gb in the movie's start state. Fails if rom is not the one
+		// the movie was recorded with, or the state does not load.
+		bool start(GB& gb, void const* rom, std::size_t romSize);
+		void endFrame();
+		bool done() const { return pos_ == movie_.size(); }
+		std::size_t frame() const { return pos_ - inputPos_; }
+		std::size_t frames() const { return movie_.size() - inputPos_; }
+
+		virtual unsigned operator()();
+
+	private:
+		std::vector<unsigned char> movie_;
+		std::size_t inputPos_;
+		std::size_t pos_;
+};
+
+}
+
+#endif
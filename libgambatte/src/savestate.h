@@ -197,6 +197,7 @@ struct SaveState {
 		} ch4;
 
 		unsigned long cycleCounter;
+		unsigned long lag;
 	} spu;
 
 	struct RTC {
@@ -222,6 +223,11 @@ struct SaveState {
 		unsigned char modeflag;
 		bool irReceivingPulse;
 	} huc3;
+
+	struct Time {
+		unsigned long seconds;
+		unsigned long ticks;
+	} time;
 };
 
 }
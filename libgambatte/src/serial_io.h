@@ -28,6 +28,19 @@ class SerialIO
 
 		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb) = 0;
 		virtual unsigned char send(unsigned char data, bool fastCgb) = 0;
+
+		// Variants that are also given the emulated time of the access, in 4194304 Hz
+		// units since power-on. Memory calls these; by default they ignore the time.
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long /*time*/) {
+			return check(out, in, fastCgb);
+		}
+		virtual unsigned char send(unsigned char data, bool fastCgb, unsigned long /*time*/) {
+			return send(data, fastCgb);
+		}
+		// SC was written without the external-clock transfer armed, so the game no
+		// longer waits for the other side and check() will not be called until it
+		// arms again.
+		virtual void disarm(unsigned long /*time*/) {}
 };
 
 }
@@ -0,0 +1,190 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#include "serial_log.h"
+#include <algorithm>
+
+namespace {
+
+enum { log_version = 1 };
+enum { flag_clocked = 1, flag_fast = 2 };
+
+unsigned char const log_tag[] = { 'G', 'B', 'S', 'L', log_version };
+
+}
+
+namespace gambatte {
+
+SerialRecorder::SerialRecorder(SerialIO* inner)
+: inner_(inner)
+{
+	reset();
+}
+
+void SerialRecorder::reset() {
+	log_.assign(log_tag, log_tag + sizeof log_tag);
+	time_ = 0;
+	lastTime_ = 0;
+}
+
+bool SerialRecorder::check(unsigned char out, unsigned char& in, bool& fastCgb) {
+	return check(out, in, fastCgb, time_);
+}
+
+unsigned char SerialRecorder::send(unsigned char data, bool fastCgb) {
+	return send(data, fastCgb, time_);
+}
+
+bool SerialRecorder::check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time) {
+	time_ = time;
+	if (!inner_ || !inner_->check(out, in, fastCgb, time))
+		return false;
+
+	record(true, fastCgb, time, in, out);
+	return true;
+}
+
+unsigned char SerialRecorder::send(unsigned char data, bool fastCgb, unsigned long time) {
+	time_ = time;
+	unsigned char const in = inner_ ? inner_->send(data, fastCgb, time) : 0xFF;
+	record(false, fastCgb, time, in, data);
+	return in;
+}
+
+void SerialRecorder::record(bool clocked, bool fastCgb, unsigned long time,
+		unsigned char data, unsigned char out) {
+	// deltas wrap along with the time itself, so a replay adds up to the same times
+	unsigned long delta = time - lastTime_;
+	lastTime_ = time;
+
+	log_.push_back((clocked ? flag_clocked : 0) | (fastCgb ? flag_fast : 0));
+	while (delta >= 0x80) {
+		log_.push_back((delta & 0x7F) | 0x80);
+		delta >>= 7;
+	}
+	log_.push_back(delta);
+	log_.push_back(data);
+	log_.push_back(out);
+}
+
+SerialReplayer::SerialReplayer()
+: log_(log_tag, log_tag + sizeof log_tag)
+{
+	rewind();
+}
+
+bool SerialReplayer::load(void const* data, std::size_t size) {
+	unsigned char const* const p = static_cast<unsigned char const*>(data);
+	if (size < sizeof log_tag || !std::equal(log_tag, log_tag + sizeof log_tag, p))
+		return false;
+
+	log_.assign(p, p + size);
+	rewind();
+
+	Record r;
+	std::size_t next;
+	while (peek(r, next))
+		pos_ = next;
+
+	bool const complete = done();
+	if (!complete)
+		log_.resize(sizeof log_tag);
+
+	rewind();
+	return complete;
+}
+
+void SerialReplayer::rewind() {
+	pos_ = sizeof log_tag;
+	time_ = 0;
+	lastTime_ = 0;
+	mismatches_ = 0;
+}
+
+bool SerialReplayer::peek(Record& r, std::size_t& next) const {
+	std::size_t pos = pos_;
+	if (pos == log_.size())
+		return false;
+
+	unsigned const flags = log_[pos++];
+	unsigned long delta = 0;
+	for (unsigned shift = 0;; shift += 7) {
+		if (pos == log_.size() || shift >= sizeof delta * 8)
+			return false;
+
+		unsigned const b = log_[pos++];
+		delta |= static_cast<unsigned long>(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			break;
+	}
+	if (log_.size() - pos < 2)
+		return false;
+
+	r.time = lastTime_ + delta;
+	r.data = log_[pos++];
+	r.out = log_[pos++];
+	r.clocked = flags & flag_clocked;
+	r.fastCgb = flags & flag_fast;
+	next = pos;
+	return true;
+}
+
+bool SerialReplayer::check(unsigned char out, unsigned char& in, bool& fastCgb) {
+	return check(out, in, fastCgb, time_);
+}
+
+unsigned char SerialReplayer::send(unsigned char data, bool fastCgb) {
+	return send(data, fastCgb, time_);
+}
+
+bool SerialReplayer::check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time) {
+	Record r;
+	std::size_t next;
+
+	time_ = time;
+	if (!peek(r, next) || !r.clocked || static_cast<long>(time - r.time) < 0)
+		return false;
+
+	if (r.out != out)
+		++mismatches_;
+
+	pos_ = next;
+	lastTime_ = r.time;
+	in = r.data;
+	fastCgb = r.fastCgb;
+	return true;
+}
+
+unsigned char SerialReplayer::send(unsigned char data, bool fastCgb, unsigned long time) {
+	Record r;
+	std::size_t next;
+
+	time_ = time;
+	if (!peek(r, next) || r.clocked) {
+		// the recorded console never clocked this byte out
+		++mismatches_;
+		return 0xFF;
+	}
+
+	if (r.out != data || r.fastCgb != fastCgb || r.time != time)
+		++mismatches_;
+
+	pos_ = next;
+	lastTime_ = r.time;
+	return r.data;
+}
+
+}
@@ -0,0 +1,101 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef SERIAL_LOG_H
+#define SERIAL_LOG_H
+
+#include "serial_io.h"
+#include <cstddef>
+#include <vector>
+
+namespace gambatte {
+
+// Link traffic log format: a "GBSL" tag and a version byte, then one record
+// per completed transfer:
+//   flags      bit 0 set if this console was clocked by the peer (check),
+//              clear if it drove the clock (send); bit 1 the CGB fast clock
+//   delta      emulated time since the previous record, LEB128
+//   data       byte this console shifted in
+//   out        byte this console shifted out
+// A few bytes per transfer, so a whole session fits in memory.
+
+// Passes everything through to another SerialIO (or acts as an unplugged
+// cable when there is none) and logs each completed transfer.
+class SerialRecorder : public SerialIO
+{
+	public:
+		explicit SerialRecorder(SerialIO* inner = 0);
+
+		void setInner(SerialIO* inner) { inner_ = inner; }
+		void reset();
+		std::vector<unsigned char> const& log() const { return log_; }
+
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
+		virtual unsigned char send(unsigned char data, bool fastCgb);
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time);
+		virtual unsigned char send(unsigned char data, bool fastCgb, unsigned long time);
+
+	private:
+		void record(bool clocked, bool fastCgb, unsigned long time, unsigned char data, unsigned char out);
+
+		SerialIO* inner_;
+		std::vector<unsigned char> log_;
+		unsigned long time_;
+		unsigned long lastTime_;
+};
+
+// Stands in for the peer of a recorded session: a console that runs the same
+// way as when it was recorded (same start, same input) gets every byte at the
+// same emulated time, without anything on the other end of the cable.
+class SerialReplayer : public SerialIO
+{
+	public:
+		SerialReplayer();
+
+		// Copies the log. Fails on anything SerialRecorder did not write.
+		bool load(void const* data, std::size_t size);
+		void rewind();
+		bool done() const { return pos_ == log_.size(); }
+		// Transfers that did not go the way they were recorded, which means
+		// the console has strayed from the recorded session.
+		unsigned long mismatches() const { return mismatches_; }
+
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb);
+		virtual unsigned char send(unsigned char data, bool fastCgb);
+		virtual bool check(unsigned char out, unsigned char& in, bool& fastCgb, unsigned long time);
+		virtual unsigned char send(unsigned char data, bool fastCgb, unsigned long time);
+
+	private:
+		struct Record {
+			unsigned long time;
+			unsigned char data;
+			unsigned char out;
+			bool clocked;
+			bool fastCgb;
+		};
+
+		bool peek(Record& r, std::size_t& next) const;
+
+		std::vector<unsigned char> log_;
+		std::size_t pos_;
+		unsigned long time_;
+		unsigned long lastTime_;
+		unsigned long mismatches_;
+};
+
+}
+
+#endif
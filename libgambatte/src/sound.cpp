@@ -18,6 +18,7 @@
  ***************************************************************************/
 #include "sound.h"
 #include "savestate.h"
+#include "sound/integrate.h"
 #include <cstring>
 #include <algorithm>
 
@@ -45,13 +46,18 @@ namespace gambatte
 
    PSG::PSG()
       :  buffer_(0)
+      ,  sink_(0)
       ,  bufferSize_(0)
       ,  bufferPos_(0)
+      ,  stepsEnd_(0)
       ,  lastUpdate_(0)
       ,  soVol_(0)
       ,  rsum_(0x8000) // initialize to 0x8000 to prevent borrows from high word, xor away later
       ,  enabled_(false)
+      ,  silent_(false)
    {
+      std::fill(stems_, stems_ + 4, static_cast<uint_least32_t *>(0));
+      std::fill(stemSums_, stemSums_ + 4, 0x8000);
    }
 
    void PSG::init(const bool cgb)
@@ -73,8 +79,11 @@ namespace gambatte
       ch3_.setStatePtrs(state);
    }
 
-   void PSG::saveState(SaveState &state)
+   void PSG::saveState(SaveState &state, unsigned long cc)
    {
+      // samples are only generated in whole units, so up to a sample's worth
+      // of cycles is left over; dropping it would shift the sample phase
+      state.spu.lag = cc - lastUpdate_;
       ch1_.saveState(state);
       ch2_.saveState(state);
       ch3_.saveState(state);
@@ -88,33 +97,106 @@ namespace gambatte
       ch3_.loadState(state);
       ch4_.loadState(state);
 
-      lastUpdate_ = state.cpu.cycleCounter;
+      lastUpdate_ = state.cpu.cycleCounter - state.spu.lag;
       setSoVolume(state.mem.ioamhram.get()[0x124]);
       mapSo(state.mem.ioamhram.get()[0x125]);
       enabled_ = state.mem.ioamhram.get()[0x126] >> 7 & 1;
    }
 
+   void PSG::setBuffer(uint_least32_t *buf, std::size_t size)
+   {
+      buffer_ = buf;
+      bufferSize_ = size;
+      bufferPos_ = 0;
+      stepsEnd_ = 0;
+
+      /* each stem picks up from where its channel is, which also keeps
+       * them adding up to the mix across state loads */
+      stemSums_[0] = (ch1_.level() + 0x8000) & 0xFFFFFFFF;
+      stemSums_[1] = (ch2_.level() + 0x8000) & 0xFFFFFFFF;
+      stemSums_[2] = (ch3_.level() + 0x8000) & 0xFFFFFFFF;
+      stemSums_[3] = (ch4_.level() + 0x8000) & 0xFFFFFFFF;
+   }
+
+   void PSG::setStems(uint_least32_t *const *stems)
+   {
+      for (int i = 0; i < 4; ++i)
+         stems_[i] = stems ? stems[i] : 0;
+   }
+
+   void PSG::updateChannels(DeltaWriter const &out, const unsigned long cycles)
+   {
+      if (stems_[0])
+      {
+         ch1_.update(out.withStem(stems_[0] + bufferPos_), soVol_, cycles);
+         ch2_.update(out.withStem(stems_[1] + bufferPos_), soVol_, cycles);
+         ch3_.update(out.withStem(stems_[2] + bufferPos_), soVol_, cycles);
+         ch4_.update(out.withStem(stems_[3] + bufferPos_), soVol_, cycles);
+         return;
+      }
+
+      ch1_.update(out, soVol_, cycles);
+      ch2_.update(out, soVol_, cycles);
+      ch3_.update(out, soVol_, cycles);
+      ch4_.update(out, soVol_, cycles);
+   }
+
    void PSG::accumulateChannels(const unsigned long cycles)
    {
-      uint_least32_t *const buf = buffer_ + bufferPos_;
-      std::memset(buf, 0, cycles * sizeof(uint_least32_t));
-      ch1_.update(buf, soVol_, cycles);
-      ch2_.update(buf, soVol_, cycles);
-      ch3_.update(buf, soVol_, cycles);
-      ch4_.update(buf, soVol_, cycles);
+      /* quiet spans before this one were left alone, they hold no steps */
+      if (stems_[0])
+      {
+         for (int i = 0; i < 4; ++i)
+            std::memset(stems_[i] + stepsEnd_, 0, (bufferPos_ + cycles - stepsEnd_) * sizeof(uint_least32_t));
+      }
+
+      if (sink_)
+      {
+         updateChannels(DeltaWriter(sink_, &rsum_, bufferPos_), cycles);
+         stepsEnd_ = bufferPos_ + cycles;
+         return;
+      }
+
+      std::memset(buffer_ + stepsEnd_, 0, (bufferPos_ + cycles - stepsEnd_) * sizeof(uint_least32_t));
+
+      updateChannels(DeltaWriter(buffer_ + bufferPos_), cycles);
+      stepsEnd_ = bufferPos_ + cycles;
+   }
+
+   void PSG::advanceChannels(const unsigned long cycles)
+   {
+      ch1_.advance(cycles);
+      ch2_.advance(cycles);
+      ch3_.advance(cycles);
+      ch4_.advance(cycles);
+   }
+
+   bool PSG::isQuiet() const
+   {
+      return ch1_.isQuiet() && ch2_.isQuiet() && ch3_.isQuiet() && ch4_.isQuiet();
    }
 
    void PSG::generateSamples(unsigned long const cycleCounter, bool const doubleSpeed)
    {
       unsigned long cycles = (cycleCounter - lastUpdate_) >> (1 + doubleSpeed);
 
-      if (cycles + bufferPos_ > bufferSize_)
+      /* when silent or sinking nothing is written, so the buffer size does
+       * not matter, but the samples are still counted. Stems are written
+       * even when sinking. */
+      if (!silent_ && (!sink_ || stems_[0]) && cycles + bufferPos_ > bufferSize_)
          cycles = (bufferSize_ > bufferPos_) ? (bufferSize_ - bufferPos_) : 0;
 
       lastUpdate_ += cycles << (1 + doubleSpeed);
 
       if (cycles)
-         accumulateChannels(cycles);
+      {
+         /* with the APU off, or every DAC, nothing changes in the output
+          * and the channels only need to keep time */
+         if (silent_ || isQuiet())
+            advanceChannels(cycles);
+         else
+            accumulateChannels(cycles);
+      }
 
       bufferPos_ += cycles;
    }
@@ -127,46 +209,25 @@ namespace gambatte
 
    size_t PSG::fillBuffer()
    {
-      uint_least32_t sum = rsum_;
-      uint_least32_t *b = buffer_;
-      unsigned n = bufferPos_;
+      if (silent_)
+         return bufferPos_;
 
-      if (unsigned n2 = n >> 3)
+      if (stems_[0])
       {
-         n -= n2 << 3;
-
-         do
+         for (int i = 0; i < 4; ++i)
          {
-            sum += b[0];
-            b[0] = sum ^ 0x8000;
-            sum += b[1];
-            b[1] = sum ^ 0x8000;
-            sum += b[2];
-            b[2] = sum ^ 0x8000;
-            sum += b[3];
-            b[3] = sum ^ 0x8000;
-            sum += b[4];
-            b[4] = sum ^ 0x8000;
-            sum += b[5];
-            b[5] = sum ^ 0x8000;
-            sum += b[6];
-            b[6] = sum ^ 0x8000;
-            sum += b[7];
-            b[7] = sum ^ 0x8000;
-
-            b += 8;
-         } while (--n2);
+            stemSums_[i] = integrateSteps(stems_[i], stepsEnd_, stemSums_[i]);
+            std::fill(stems_[i] + stepsEnd_, stems_[i] + bufferPos_, stemSums_[i] ^ 0x8000);
+         }
       }
 
-      while (n--)
-      {
-         sum += *b;
-         /* xor away the initial rsum value of 0x8000 (which prevents 
-          * borrows from the high word) from the low word */
-         *b++ = sum ^ 0x8000;
-      }
+      if (sink_)
+         return bufferPos_;
 
-      rsum_ = sum;
+      /* the initial rsum value of 0x8000 prevents borrows from the high
+       * word, and is xored away from the low word of each sample */
+      rsum_ = integrateSteps(buffer_, stepsEnd_, rsum_);
+      std::fill(buffer_ + stepsEnd_, buffer_ + bufferPos_, rsum_ ^ 0x8000);
 
       return bufferPos_;
    }
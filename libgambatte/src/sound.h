@@ -26,6 +26,7 @@
 #include "sound/channel2.h"
 #include "sound/channel3.h"
 #include "sound/channel4.h"
+#include "soundsink.h"
 
 namespace gambatte {
 
@@ -35,16 +36,25 @@ public:
 	void init(bool cgb);
 	void reset();
 	void setStatePtrs(SaveState &state);
-	void saveState(SaveState &state);
+	void saveState(SaveState &state, unsigned long cc);
 	void loadState(SaveState const &state);
 
 	void generateSamples(unsigned long cycleCounter, bool doubleSpeed);
 	void resetCounter(unsigned long newCc, unsigned long oldCc, bool doubleSpeed);
    std::size_t fillBuffer();
-	void setBuffer(uint_least32_t *buf, std::size_t size) { buffer_ = buf; bufferSize_ = size; bufferPos_ = 0; }
+	void setBuffer(uint_least32_t *buf, std::size_t size);
+	// Whether the output held one level, level, over all the samples since
+	// setBuffer.
+	bool isFlat(uint_least32_t &level) const { level = rsum_ ^ 0x8000; return !stepsEnd_; }
 
 	bool isEnabled() const { return enabled_; }
 	void setEnabled(bool value) { enabled_ = value; }
+	void setSilent(bool silent) { silent_ = silent; }
+	void setSink(SoundSink *sink) { sink_ = sink; }
+	// Also writes each channel's output on its own to stems[0] to stems[3],
+	// sample for sample alongside the buffer and with room for as many
+	// samples, or nothing if stems is 0.
+	void setStems(uint_least32_t *const *stems);
 
 	void setNr10(unsigned data) { ch1_.setNr0(data); }
 	void setNr11(unsigned data) { ch1_.setNr1(data); }
@@ -80,14 +90,22 @@ private:
 	Channel3 ch3_;
 	Channel4 ch4_;
 	uint_least32_t *buffer_;
+	uint_least32_t *stems_[4];
+	uint_least32_t stemSums_[4];
+	SoundSink *sink_;
 	std::size_t bufferSize_;
 	std::size_t bufferPos_;
+	std::size_t stepsEnd_;
 	unsigned long lastUpdate_;
 	unsigned long soVol_;
 	uint_least32_t rsum_;
 	bool enabled_;
+	bool silent_;
 
 	void accumulateChannels(unsigned long cycles);
+	void updateChannels(DeltaWriter const &out, unsigned long cycles);
+	void advanceChannels(unsigned long cycles);
+	bool isQuiet() const;
 };
 
 }
@@ -214,7 +214,7 @@ void Channel1::loadState(SaveState const &state) {
 	master_ = state.spu.ch1.master;
 }
 
-void Channel1::update(uint_least32_t *buf, unsigned long const soBaseVol, unsigned long cycles) {
+void Channel1::update(DeltaWriter buf, unsigned long const soBaseVol, unsigned long cycles) {
 	unsigned long const outBase = envelopeUnit_.dacIsOn() ? soBaseVol & soMask_ : 0;
 	unsigned long const outLow = outBase * (0 - 15ul);
 	unsigned long const endCycles = cycleCounter_ + cycles;
@@ -227,9 +227,9 @@ void Channel1::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		unsigned long out = dutyUnit_.isHighState() ? outHigh : outLow;
 
 		while (dutyUnit_.counter() <= nextMajorEvent) {
-			*buf = out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += dutyUnit_.counter() - cycleCounter_;
+			buf.skip(dutyUnit_.counter() - cycleCounter_);
 			cycleCounter_ = dutyUnit_.counter();
 
 			dutyUnit_.event();
@@ -237,9 +237,9 @@ void Channel1::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		}
 
 		if (cycleCounter_ < nextMajorEvent) {
-			*buf = out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += nextMajorEvent - cycleCounter_;
+			buf.skip(nextMajorEvent - cycleCounter_);
 			cycleCounter_ = nextMajorEvent;
 		}
 
@@ -250,6 +250,26 @@ void Channel1::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 			break;
 	}
 
+	wrapCounters();
+}
+
+void Channel1::advance(unsigned long const cycles) {
+	unsigned long const endCycles = cycleCounter_ + cycles;
+
+	// duty edges only show in the output, the duty unit can tell its
+	// position from the time alone
+	while (nextEventUnit_->counter() <= endCycles) {
+		cycleCounter_ = nextEventUnit_->counter();
+		nextEventUnit_->event();
+		setEvent();
+	}
+
+	cycleCounter_ = endCycles;
+	dutyUnit_.catchUp(cycleCounter_);
+	wrapCounters();
+}
+
+void Channel1::wrapCounters() {
 	if (cycleCounter_ >= SoundUnit::counter_max) {
 		dutyUnit_.resetCounters(cycleCounter_);
 		lengthCounter_.resetCounters(cycleCounter_);
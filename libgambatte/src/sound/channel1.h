@@ -19,6 +19,7 @@
 #ifndef SOUND_CHANNEL1_H
 #define SOUND_CHANNEL1_H
 
+#include "delta_writer.h"
 #include "duty_unit.h"
 #include "envelope_unit.h"
 #include "gbint.h"
@@ -40,7 +41,14 @@ public:
 	void setNr4(unsigned data);
 	void setSo(unsigned long soMask);
 	bool isActive() const { return master_; }
-	void update(uint_least32_t *buf, unsigned long soBaseVol, unsigned long cycles);
+	// Whether the output is at 0 and stays there until the DAC or the
+	// panning changes.
+	bool isQuiet() const { return !prevOut_ && !(envelopeUnit_.dacIsOn() && soMask_); }
+	// The output level, packed the way the PSG mixes it.
+	unsigned long level() const { return prevOut_; }
+	void update(DeltaWriter buf, unsigned long soBaseVol, unsigned long cycles);
+	// Runs the channel without producing output.
+	void advance(unsigned long cycles);
 	void reset();
 	void init(bool cgb);
 	void saveState(SaveState &state);
@@ -85,6 +93,7 @@ private:
 	bool master_;
 
 	void setEvent();
+	void wrapCounters();
 };
 
 }
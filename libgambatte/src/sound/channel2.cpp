@@ -113,7 +113,7 @@ void Channel2::loadState(SaveState const &state) {
 	master_ = state.spu.ch2.master;
 }
 
-void Channel2::update(uint_least32_t *buf, unsigned long const soBaseVol, unsigned long cycles) {
+void Channel2::update(DeltaWriter buf, unsigned long const soBaseVol, unsigned long cycles) {
 	unsigned long const outBase = envelopeUnit_.dacIsOn() ? soBaseVol & soMask_ : 0;
 	unsigned long const outLow = outBase * (0 - 15ul);
 	unsigned long const endCycles = cycleCounter_ + cycles;
@@ -126,9 +126,9 @@ void Channel2::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		unsigned long out = dutyUnit_.isHighState() ? outHigh : outLow;
 
 		while (dutyUnit_.counter() <= nextMajorEvent) {
-			*buf += out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += dutyUnit_.counter() - cycleCounter_;
+			buf.skip(dutyUnit_.counter() - cycleCounter_);
 			cycleCounter_ = dutyUnit_.counter();
 
 			dutyUnit_.event();
@@ -136,9 +136,9 @@ void Channel2::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		}
 
 		if (cycleCounter_ < nextMajorEvent) {
-			*buf += out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += nextMajorEvent - cycleCounter_;
+			buf.skip(nextMajorEvent - cycleCounter_);
 			cycleCounter_ = nextMajorEvent;
 		}
 
@@ -149,6 +149,26 @@ void Channel2::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 			break;
 	}
 
+	wrapCounters();
+}
+
+void Channel2::advance(unsigned long const cycles) {
+	unsigned long const endCycles = cycleCounter_ + cycles;
+
+	// duty edges only show in the output, the duty unit can tell its
+	// position from the time alone
+	while (nextEventUnit->counter() <= endCycles) {
+		cycleCounter_ = nextEventUnit->counter();
+		nextEventUnit->event();
+		setEvent();
+	}
+
+	cycleCounter_ = endCycles;
+	dutyUnit_.catchUp(cycleCounter_);
+	wrapCounters();
+}
+
+void Channel2::wrapCounters() {
 	if (cycleCounter_ >= SoundUnit::counter_max) {
 		dutyUnit_.resetCounters(cycleCounter_);
 		lengthCounter_.resetCounters(cycleCounter_);
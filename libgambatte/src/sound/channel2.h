@@ -19,6 +19,7 @@
 #ifndef SOUND_CHANNEL2_H
 #define SOUND_CHANNEL2_H
 
+#include "delta_writer.h"
 #include "duty_unit.h"
 #include "envelope_unit.h"
 #include "gbint.h"
@@ -38,7 +39,14 @@ public:
 	void setNr4(unsigned data);
 	void setSo(unsigned long soMask);
 	bool isActive() const { return master_; }
-	void update(uint_least32_t *buf, unsigned long soBaseVol, unsigned long cycles);
+	// Whether the output is at 0 and stays there until the DAC or the
+	// panning changes.
+	bool isQuiet() const { return !prevOut_ && !(envelopeUnit_.dacIsOn() && soMask_); }
+	// The output level, packed the way the PSG mixes it.
+	unsigned long level() const { return prevOut_; }
+	void update(DeltaWriter buf, unsigned long soBaseVol, unsigned long cycles);
+	// Runs the channel without producing output.
+	void advance(unsigned long cycles);
 	void reset();
 	void saveState(SaveState &state);
 	void loadState(SaveState const &state);
@@ -59,6 +67,7 @@ private:
 	bool master_;
 
 	void setEvent();
+	void wrapCounters();
 };
 
 }
@@ -142,7 +142,7 @@ void Channel3::updateWaveCounter(unsigned long const cc) {
 	}
 }
 
-void Channel3::update(uint_least32_t *buf, unsigned long const soBaseVol, unsigned long cycles) {
+void Channel3::update(DeltaWriter buf, unsigned long const soBaseVol, unsigned long cycles) {
 	unsigned long const outBase = nr0_/* & 0x80*/ ? soBaseVol & soMask_ : 0;
 
 	if (outBase && rshift_ != 4) {
@@ -157,9 +157,9 @@ void Channel3::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 			out *= outBase;
 
 			while (waveCounter_ <= nextMajorEvent) {
-				*buf += out - prevOut_;
+				buf.add(out - prevOut_);
 				prevOut_ = out;
-				buf += waveCounter_ - cycleCounter_;
+				buf.skip(waveCounter_ - cycleCounter_);
 				cycleCounter_ = waveCounter_;
 
 				lastReadTime_ = waveCounter_;
@@ -172,9 +172,9 @@ void Channel3::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 			}
 
 			if (cycleCounter_ < nextMajorEvent) {
-				*buf += out - prevOut_;
+				buf.add(out - prevOut_);
 				prevOut_ = out;
-				buf += nextMajorEvent - cycleCounter_;
+				buf.skip(nextMajorEvent - cycleCounter_);
 				cycleCounter_ = nextMajorEvent;
 			}
 
@@ -185,18 +185,27 @@ void Channel3::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		}
 	} else {
 		unsigned long const out = outBase * (0 - 15ul);
-		*buf += out - prevOut_;
+		buf.add(out - prevOut_);
 		prevOut_ = out;
-		cycleCounter_ += cycles;
+		return advance(cycles);
+	}
 
-		while (lengthCounter_.counter() <= cycleCounter_) {
-			updateWaveCounter(lengthCounter_.counter());
-			lengthCounter_.event();
-		}
+	wrapCounters();
+}
 
-		updateWaveCounter(cycleCounter_);
+void Channel3::advance(unsigned long const cycles) {
+	cycleCounter_ += cycles;
+
+	while (lengthCounter_.counter() <= cycleCounter_) {
+		updateWaveCounter(lengthCounter_.counter());
+		lengthCounter_.event();
 	}
 
+	updateWaveCounter(cycleCounter_);
+	wrapCounters();
+}
+
+void Channel3::wrapCounters() {
 	if (cycleCounter_ >= SoundUnit::counter_max) {
 		lengthCounter_.resetCounters(cycleCounter_);
 
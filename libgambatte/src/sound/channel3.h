@@ -19,6 +19,7 @@
 #ifndef SOUND_CHANNEL3_H
 #define SOUND_CHANNEL3_H
 
+#include "delta_writer.h"
 #include "gbint.h"
 #include "length_counter.h"
 #include "master_disabler.h"
@@ -31,6 +32,11 @@ class Channel3 {
 public:
 	Channel3();
 	bool isActive() const { return master_; }
+	// Whether the output is at 0 and stays there until the DAC or the
+	// panning changes.
+	bool isQuiet() const { return !prevOut_ && !(nr0_ && soMask_); }
+	// The output level, packed the way the PSG mixes it.
+	unsigned long level() const { return prevOut_; }
 	void reset();
 	void init(bool cgb);
 	void setStatePtrs(SaveState &state);
@@ -42,7 +48,9 @@ public:
 	void setNr3(unsigned data) { nr3_ = data; }
 	void setNr4(unsigned data);
 	void setSo(unsigned long soMask);
-	void update(uint_least32_t *buf, unsigned long soBaseVol, unsigned long cycles);
+	void update(DeltaWriter buf, unsigned long soBaseVol, unsigned long cycles);
+	// Runs the channel without producing output.
+	void advance(unsigned long cycles);
 
 	unsigned waveRamRead(unsigned index) const {
 		if (master_) {
@@ -98,6 +106,7 @@ private:
 	bool cgb_;
 
 	void updateWaveCounter(unsigned long cc);
+	void wrapCounters();
 };
 
 }
@@ -32,10 +32,73 @@ static unsigned long toPeriod(unsigned const nr3) {
 	return r << s;
 }
 
+namespace {
+
+enum { lfsr15_len = 0x7FFF, lfsr7_len = 0x7F };
+
+unsigned lfsrStep(unsigned reg, bool narrow) {
+	unsigned const shifted = reg >> 1;
+	unsigned const xored = (reg ^ shifted) & 1;
+	reg = shifted | xored << 14;
+
+	return narrow ? (reg & ~0x40) | xored << 6 : reg;
+}
+
+// Both LFSR sequences laid out once, so that the noise channel can skip over
+// any number of clocks, and over every clock that leaves the output as it is.
+// Any nonzero 15-bit register is somewhere on the one 32767-step sequence.
+// In 7-bit mode the low 7 bits run through 127 steps on their own, and the
+// upper bits are shifted in from them, so after 8 clocks the whole register
+// is down to the position in the short sequence.
+struct LfsrTables {
+	unsigned short reg15[lfsr15_len];
+	unsigned short pos15[0x8000];
+	unsigned char run15[lfsr15_len]; // clocks until the output changes
+	unsigned short reg7[lfsr7_len];
+	unsigned char pos7[0x80];
+	unsigned char run7[lfsr7_len];
+
+	LfsrTables() {
+		unsigned reg = 0x7FFF;
+		for (unsigned i = 0; i < lfsr15_len; ++i) {
+			reg15[i] = reg;
+			pos15[reg] = i;
+			reg = lfsrStep(reg, false);
+		}
+
+		for (unsigned i = 0; i < 8; ++i)
+			reg = lfsrStep(reg, true);
+
+		for (unsigned i = 0; i < lfsr7_len; ++i) {
+			reg7[i] = reg;
+			pos7[reg & 0x7F] = i;
+			reg = lfsrStep(reg, true);
+		}
+
+		fillRuns(run15, reg15, lfsr15_len);
+		fillRuns(run7, reg7, lfsr7_len);
+	}
+
+	static void fillRuns(unsigned char *run, unsigned short const *reg, unsigned len) {
+		for (unsigned i = 0; i < len; ++i) {
+			unsigned n = 1;
+			while (!((reg[(i + n) % len] ^ reg[i]) & 1))
+				++n;
+
+			run[i] = n;
+		}
+	}
+};
+
+LfsrTables const lfsrTables;
+
+}
+
 namespace gambatte {
 
 Channel4::Lfsr::Lfsr()
 : backupCounter_(counter_disabled)
+, pos_(0)
 , reg_(0x7FFF)
 , nr3_(0)
 , master_(false)
@@ -89,6 +152,91 @@ inline void Channel4::Lfsr::event() {
 	backupCounter_ = counter_;
 }
 
+bool Channel4::Lfsr::seek() {
+	// pos_ usually still matches from the previous call, and then the
+	// tables are walked in order
+	if (nr3_ & 8) {
+		if (pos_ < lfsr7_len && lfsrTables.reg7[pos_] == reg_)
+			return true;
+
+		unsigned const pos = lfsrTables.pos7[reg_ & 0x7F];
+		if (lfsrTables.reg7[pos] != reg_)
+			return false;
+
+		pos_ = pos;
+		return true;
+	}
+
+	if (lfsrTables.reg15[pos_] == reg_)
+		return true;
+	if (!reg_)
+		return false;
+
+	pos_ = lfsrTables.pos15[reg_];
+	return true;
+}
+
+unsigned long Channel4::Lfsr::clockUntil(unsigned long const end, bool const toToggle) {
+	unsigned long const period = toPeriod(nr3_);
+
+	if (toToggle && nr3_ < 0xE0 && seek()) {
+		bool const narrow = nr3_ & 8;
+		unsigned const run = narrow ? lfsrTables.run7[pos_] : lfsrTables.run15[pos_];
+
+		if ((run - 1) * period <= end - counter_) {
+			unsigned const len = narrow ? lfsr7_len : lfsr15_len;
+			pos_ += run;
+			if (pos_ >= len)
+				pos_ -= len;
+
+			reg_ = narrow ? lfsrTables.reg7[pos_] : lfsrTables.reg15[pos_];
+			counter_ += run * period;
+			backupCounter_ = counter_;
+			return counter_ - period;
+		}
+	}
+
+	unsigned long n = (end - counter_) / period + 1;
+
+	if (nr3_ < 0xE0) {
+		if (toToggle)
+			n = std::min(n, clocksToToggle());
+
+		skipClocks(n);
+	}
+
+	counter_ += n * period;
+	backupCounter_ = counter_;
+	return counter_ - period;
+}
+
+void Channel4::Lfsr::skipClocks(unsigned long n) {
+	if (nr3_ & 8) {
+		if (n >= 8 && reg_ & 0x7F) {
+			pos_ = (lfsrTables.pos7[reg_ & 0x7F] + n % lfsr7_len) % lfsr7_len;
+			reg_ = lfsrTables.reg7[pos_];
+			return;
+		}
+
+		// low bits stuck at 0 empty the register within 15 clocks
+		for (n = std::min(n, 15ul); n; --n)
+			reg_ = lfsrStep(reg_, true);
+	} else if (seek()) {
+		pos_ = (pos_ + n % lfsr15_len) % lfsr15_len;
+		reg_ = lfsrTables.reg15[pos_];
+	}
+}
+
+unsigned long Channel4::Lfsr::clocksToToggle() const {
+	if (nr3_ & 8) {
+		return reg_ & 0x7F
+		     ? lfsrTables.run7[lfsrTables.pos7[reg_ & 0x7F]]
+		     : static_cast<unsigned long>(counter_disabled);
+	}
+
+	return reg_ ? lfsrTables.run15[lfsrTables.pos15[reg_]] : static_cast<unsigned long>(counter_disabled);
+}
+
 void Channel4::Lfsr::nr3Change(unsigned newNr3, unsigned long cc) {
 	updateBackupCounter(cc);
 	nr3_ = newNr3;
@@ -216,7 +364,7 @@ void Channel4::loadState(SaveState const &state) {
 	master_ = state.spu.ch4.master;
 }
 
-void Channel4::update(uint_least32_t *buf, unsigned long const soBaseVol, unsigned long cycles) {
+void Channel4::update(DeltaWriter buf, unsigned long const soBaseVol, unsigned long cycles) {
 	unsigned long const outBase = envelopeUnit_.dacIsOn() ? soBaseVol & soMask_ : 0;
 	unsigned long const outLow = outBase * (0 - 15ul);
 	unsigned long const endCycles = cycleCounter_ + cycles;
@@ -227,19 +375,20 @@ void Channel4::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 		unsigned long out = lfsr_.isHighState() ? outHigh : outLow;
 
 		while (lfsr_.counter() <= nextMajorEvent) {
-			*buf += out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += lfsr_.counter() - cycleCounter_;
-			cycleCounter_ = lfsr_.counter();
 
-			lfsr_.event();
+			// clocks that leave the output as it is would only add zeros
+			unsigned long const lastClock = lfsr_.clockUntil(nextMajorEvent, true);
+			buf.skip(lastClock - cycleCounter_);
+			cycleCounter_ = lastClock;
 			out = lfsr_.isHighState() ? outHigh : outLow;
 		}
 
 		if (cycleCounter_ < nextMajorEvent) {
-			*buf += out - prevOut_;
+			buf.add(out - prevOut_);
 			prevOut_ = out;
-			buf += nextMajorEvent - cycleCounter_;
+			buf.skip(nextMajorEvent - cycleCounter_);
 			cycleCounter_ = nextMajorEvent;
 		}
 
@@ -250,6 +399,34 @@ void Channel4::update(uint_least32_t *buf, unsigned long const soBaseVol, unsign
 			break;
 	}
 
+	wrapCounters();
+}
+
+void Channel4::advance(unsigned long const cycles) {
+	unsigned long const endCycles = cycleCounter_ + cycles;
+
+	// the lfsr is clocked the way update does it; the catch-up in
+	// updateBackupCounter does not keep the upper bits the way the hardware
+	// does in 7-bit mode
+	for (;;) {
+		unsigned long const nextMajorEvent = std::min(nextEventUnit_->counter(), endCycles);
+
+		if (lfsr_.counter() <= nextMajorEvent)
+			lfsr_.clockUntil(nextMajorEvent, false);
+
+		cycleCounter_ = nextMajorEvent;
+
+		if (nextEventUnit_->counter() == nextMajorEvent) {
+			nextEventUnit_->event();
+			setEvent();
+		} else
+			break;
+	}
+
+	wrapCounters();
+}
+
+void Channel4::wrapCounters() {
 	if (cycleCounter_ >= SoundUnit::counter_max) {
 		lengthCounter_.resetCounters(cycleCounter_);
 		lfsr_.resetCounters(cycleCounter_);
@@ -19,6 +19,7 @@
 #ifndef SOUND_CHANNEL4_H
 #define SOUND_CHANNEL4_H
 
+#include "delta_writer.h"
 #include "envelope_unit.h"
 #include "gbint.h"
 #include "length_counter.h"
@@ -38,7 +39,14 @@ public:
 	void setNr4(unsigned data);
 	void setSo(unsigned long soMask);
 	bool isActive() const { return master_; }
-	void update(uint_least32_t *buf, unsigned long soBaseVol, unsigned long cycles);
+	// Whether the output is at 0 and stays there until the DAC or the
+	// panning changes.
+	bool isQuiet() const { return !prevOut_ && !(envelopeUnit_.dacIsOn() && soMask_); }
+	// The output level, packed the way the PSG mixes it.
+	unsigned long level() const { return prevOut_; }
+	void update(DeltaWriter buf, unsigned long soBaseVol, unsigned long cycles);
+	// Runs the channel without producing output.
+	void advance(unsigned long cycles);
 	void reset();
 	void saveState(SaveState &state);
 	void loadState(SaveState const &state);
@@ -50,6 +58,10 @@ private:
 		virtual void event();
 		virtual void resetCounters(unsigned long oldCc);
 		bool isHighState() const { return ~reg_ & 1; }
+		// Clocks at each clock time up to end, which must not come before
+		// the next, and no further than the first clock that changes the
+		// output if toToggle. Returns the time of the last clock.
+		unsigned long clockUntil(unsigned long end, bool toToggle);
 		void nr3Change(unsigned newNr3, unsigned long cc);
 		void nr4Init(unsigned long cc);
 		void reset(unsigned long cc);
@@ -61,11 +73,15 @@ private:
 
 	private:
 		unsigned long backupCounter_;
+		unsigned pos_; // where reg_ was last found in the sequence tables
 		unsigned short reg_;
 		unsigned char nr3_;
 		bool master_;
 
 		void updateBackupCounter(unsigned long cc);
+		bool seek();
+		void skipClocks(unsigned long n);
+		unsigned long clocksToToggle() const;
 	};
 
 	class Ch4MasterDisabler : public MasterDisabler {
@@ -92,6 +108,7 @@ private:
 	bool master_;
 
 	void setEvent();
+	void wrapCounters();
 };
 
 }
@@ -0,0 +1,84 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef DELTA_WRITER_H
+#define DELTA_WRITER_H
+
+#include "gbint.h"
+#include "soundsink.h"
+
+namespace gambatte {
+
+// Where a channel puts the steps in its output: added into a buffer with a
+// word per sample, which the PSG integrates afterwards, or handed straight to
+// a SoundSink along with their time. Both stereo sides are packed into a word
+// the way the PSG mixes them. A channel's steps can also go into a stem
+// buffer of its own, laid out the same as the buffer.
+class DeltaWriter {
+public:
+	explicit DeltaWriter(uint_least32_t *buf)
+	: buf_(buf), stem_(0), sink_(0), sum_(0), time_(0), pos_(0)
+	{
+	}
+
+	DeltaWriter(SoundSink *sink, uint_least32_t *sum, unsigned long time)
+	: buf_(0), stem_(0), sink_(sink), sum_(sum), time_(time), pos_(0)
+	{
+	}
+
+	DeltaWriter withStem(uint_least32_t *stem) const {
+		DeltaWriter w(*this);
+		w.stem_ = stem;
+		return w;
+	}
+
+	void add(uint_least32_t delta) {
+		if (stem_)
+			stem_[pos_] += delta;
+		if (!sink_)
+			buf_[pos_] += delta;
+		else if (delta)
+			addToSink(delta);
+	}
+
+	void skip(unsigned long samples) { pos_ += samples; }
+
+private:
+	uint_least32_t *buf_;
+	uint_least32_t *stem_;
+	SoundSink *sink_;
+	uint_least32_t *sum_;
+	unsigned long time_;
+	unsigned long pos_;
+
+	void addToSink(uint_least32_t delta) {
+		// keeps the running sum where integrating a buffer would have left it
+		*sum_ += delta;
+
+		// the low half borrows from the high half when it goes negative
+		long const lo = static_cast<long>((delta & 0xFFFF) ^ 0x8000) - 0x8000;
+		long const hi = static_cast<long>(((delta - lo) >> 16 & 0xFFFF) ^ 0x8000) - 0x8000;
+#ifdef WORDS_BIGENDIAN
+		sink_->addDelta(time_ + pos_, hi, lo);
+#else
+		sink_->addDelta(time_ + pos_, lo, hi);
+#endif
+	}
+};
+
+}
+
+#endif
@@ -155,4 +155,9 @@ void DutyUnit::reviveCounter(unsigned long const cc) {
 	setCounter();
 }
 
+void DutyUnit::catchUp(unsigned long const cc) {
+	updatePos(cc);
+	setCounter();
+}
+
 }
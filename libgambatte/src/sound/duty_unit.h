@@ -39,6 +39,8 @@ public:
 	void loadState(SaveState::SPU::Duty const &dstate, unsigned nr1, unsigned nr4, unsigned long cc);
 	void killCounter();
 	void reviveCounter(unsigned long cc);
+	// Brings the event counter up to cc after events were left unhandled.
+	void catchUp(unsigned long cc);
 
 	//intended for use by SweepUnit only.
 	unsigned freq() const { return 2048 - (period_ >> 1); }
@@ -0,0 +1,174 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#include "integrate.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) \
+		&& (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+#define INTEGRATE_X86_DISPATCH
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INTEGRATE_SSE2
+#include <emmintrin.h>
+#define TARGET(isa)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define INTEGRATE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+using gambatte::uint_least32_t;
+
+typedef uint_least32_t (*Integrator)(uint_least32_t *buf, std::size_t n, uint_least32_t sum);
+
+uint_least32_t integrateScalar(uint_least32_t *b, std::size_t n, uint_least32_t sum) {
+	if (std::size_t n8 = n >> 3) {
+		n -= n8 << 3;
+
+		do {
+			sum += b[0];
+			b[0] = sum ^ 0x8000;
+			sum += b[1];
+			b[1] = sum ^ 0x8000;
+			sum += b[2];
+			b[2] = sum ^ 0x8000;
+			sum += b[3];
+			b[3] = sum ^ 0x8000;
+			sum += b[4];
+			b[4] = sum ^ 0x8000;
+			sum += b[5];
+			b[5] = sum ^ 0x8000;
+			sum += b[6];
+			b[6] = sum ^ 0x8000;
+			sum += b[7];
+			b[7] = sum ^ 0x8000;
+
+			b += 8;
+		} while (--n8);
+	}
+
+	while (n--) {
+		sum += *b;
+		*b++ = sum ^ 0x8000;
+	}
+
+	return sum;
+}
+
+// The vector versions sum each vector in log2(lanes) shifted adds, then add
+// the sum carried over from the vectors before it. Only the carry depends on
+// the previous vector, and it takes one add to update. Words wrap the same
+// way whatever order they are added in, so the output is the same as the
+// scalar loop's.
+
+#if defined(INTEGRATE_X86_DISPATCH) || defined(INTEGRATE_SSE2)
+
+TARGET("sse2")
+uint_least32_t integrateSse2(uint_least32_t *b, std::size_t n, uint_least32_t sum) {
+	__m128i const bias = _mm_set1_epi32(0x8000);
+	__m128i carry = _mm_set1_epi32(sum);
+	std::size_t i = 0;
+
+	for (; i + 4 <= n; i += 4) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(b + i));
+		v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+		v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(b + i), _mm_xor_si128(_mm_add_epi32(v, carry), bias));
+		carry = _mm_add_epi32(carry, _mm_shuffle_epi32(v, 0xFF));
+	}
+
+	return integrateScalar(b + i, n - i, _mm_cvtsi128_si32(carry));
+}
+
+#endif
+
+#ifdef INTEGRATE_X86_DISPATCH
+
+TARGET("avx2")
+uint_least32_t integrateAvx2(uint_least32_t *b, std::size_t n, uint_least32_t sum) {
+	__m256i const bias = _mm256_set1_epi32(0x8000);
+	__m256i const last = _mm256_set1_epi32(7);
+	__m256i carry = _mm256_set1_epi32(sum);
+	std::size_t i = 0;
+
+	for (; i + 8 <= n; i += 8) {
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b + i));
+		// the shifts stay within each 128-bit half, so the low half's total
+		// is carried into the high half separately
+		v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+		v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+		v = _mm256_add_epi32(v, _mm256_shuffle_epi32(_mm256_permute2x128_si256(v, v, 0x08), 0xFF));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(b + i), _mm256_xor_si256(_mm256_add_epi32(v, carry), bias));
+		carry = _mm256_add_epi32(carry, _mm256_permutevar8x32_epi32(v, last));
+	}
+
+	return integrateSse2(b + i, n - i, _mm_cvtsi128_si32(_mm256_castsi256_si128(carry)));
+}
+
+Integrator pickIntegrator() {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return integrateAvx2;
+	if (__builtin_cpu_supports("sse2"))
+		return integrateSse2;
+
+	return integrateScalar;
+}
+
+#elif defined(INTEGRATE_SSE2)
+
+Integrator pickIntegrator() { return integrateSse2; }
+
+#elif defined(INTEGRATE_NEON)
+
+uint_least32_t integrateNeon(uint_least32_t *b, std::size_t n, uint_least32_t sum) {
+	uint32x4_t const bias = vdupq_n_u32(0x8000);
+	uint32x4_t const zero = vdupq_n_u32(0);
+	uint32x4_t carry = vdupq_n_u32(sum);
+	std::size_t i = 0;
+
+	for (; i + 4 <= n; i += 4) {
+		uint32x4_t v = vld1q_u32(reinterpret_cast<uint32_t const *>(b + i));
+		v = vaddq_u32(v, vextq_u32(zero, v, 3));
+		v = vaddq_u32(v, vextq_u32(zero, v, 2));
+		vst1q_u32(reinterpret_cast<uint32_t *>(b + i), veorq_u32(vaddq_u32(v, carry), bias));
+		carry = vaddq_u32(carry, vdupq_n_u32(vgetq_lane_u32(v, 3)));
+	}
+
+	return integrateScalar(b + i, n - i, vgetq_lane_u32(carry, 0));
+}
+
+Integrator pickIntegrator() { return integrateNeon; }
+
+#else
+
+Integrator pickIntegrator() { return integrateScalar; }
+
+#endif
+
+Integrator const integrator = sizeof(uint_least32_t) == 4 ? pickIntegrator() : integrateScalar;
+
+}
+
+namespace gambatte {
+
+uint_least32_t integrateSteps(uint_least32_t *buf, std::size_t n, uint_least32_t sum) {
+	return integrator(buf, n, sum);
+}
+
+}
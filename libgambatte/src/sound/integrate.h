@@ -0,0 +1,33 @@
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License version 2 as
+//   published by the Free Software Foundation.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License version 2 for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   version 2 along with this program; if not, write to the
+//   Free Software Foundation, Inc.,
+//   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+
+#ifndef SOUND_INTEGRATE_H
+#define SOUND_INTEGRATE_H
+
+#include "gbint.h"
+#include <cstddef>
+
+namespace gambatte {
+
+// Turns the n words at buf, which hold the steps in the output, into the output
+// itself: each word becomes the running sum from sum on, with the 0x8000 that
+// keeps the low half from borrowing xored away. Returns the sum after the last
+// word. Uses the widest vector unit the CPU has.
+uint_least32_t integrateSteps(uint_least32_t *buf, std::size_t n, uint_least32_t sum);
+
+}
+
+#endif
@@ -418,6 +418,7 @@ SaverList::SaverList() {
 	{ static const char label[] = { w,e,m,a,s,t,r, NUL }; ADD(ppu.weMaster); }
 	{ static const char label[] = { l,c,d,s,i,r,q, NUL }; ADD(ppu.pendingLcdstatIrq); }
 	{ static const char label[] = { s,p,u,c,n,t,r, NUL }; ADD(spu.cycleCounter); }
+	{ static const char label[] = { s,p,u,l,a,g,   NUL }; ADD(spu.lag); }
 	{ static const char label[] = { s,w,p,c,n,t,r, NUL }; ADD(spu.ch1.sweep.counter); }
 	{ static const char label[] = { s,w,p,s,h,d,w, NUL }; ADD(spu.ch1.sweep.shadow); }
 	{ static const char label[] = { s,w,p,n,e,g,   NUL }; ADD(spu.ch1.sweep.negging); }
@@ -478,6 +479,8 @@ SaverList::SaverList() {
 	{ static const char label[] = { h,NO3,m,f,     NUL }; ADD(huc3.modeflag); }
 	{ static const char label[] = { h,NO3,i,r,c,y, NUL }; ADD(huc3.irBaseCycle); }
 	{ static const char label[] = { h,NO3,i,r,a,c, NUL }; ADD(huc3.irReceivingPulse); }
+	{ static const char label[] = { t,i,m,e,s,e,c, NUL }; ADD(time.seconds); }
+	{ static const char label[] = { t,i,m,e,t,i,c, NUL }; ADD(time.ticks); }
 	
 #undef ADD
 #undef ADDPTR
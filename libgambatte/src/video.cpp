@@ -144,10 +144,10 @@ void LCD::refreshPalettes()
          ppu_.bgPalette()[i >> 1] = gbcToRgb32( bgpData_[i] |  bgpData_[i + 1] << 8);
          ppu_.spPalette()[i >> 1] = gbcToRgb32(objpData_[i] | objpData_[i + 1] << 8);
       }
-      /* CGB mode: rebuild all 8 BG palette expansions, the CGB
-       * renderer's hot do-while indexes [nattrib & 7] per tile. */
+      /* CGB mode: all 8 BG palette expansions, the CGB renderer's
+       * hot do-while indexes [nattrib & 7] per tile. */
       for (unsigned p = 0; p < 8; ++p)
-         ppu_.refreshBgPaletteExpansion(p);
+         ppu_.bgPaletteChanged(p);
    }
    else
    {
@@ -160,8 +160,8 @@ void LCD::refreshPalettes()
       setDmgPalette(ppu_.spPalette()    , dmgColorsRgb32_ + 4, objpData_[0]);
       setDmgPalette(ppu_.spPalette() + 4, dmgColorsRgb32_ + 8, objpData_[1]);
       /* DMG mode: only palette 0 is used by doFullTilesUnrolledDmg.
-       * Rebuild slot 0; slots 1..7 are unused but stay zero-init. */
-      ppu_.refreshBgPaletteExpansion(0);
+       * Slots 1..7 are unused but stay zero-init. */
+      ppu_.bgPaletteChanged(0);
    }
 }
 
@@ -296,8 +296,10 @@ void LCD::doCgbBgColorChange(unsigned index, const unsigned data, const unsigned
        * (palette[index >> 1] in doCgbColorChange).  Each CGB palette
        * has 4 entries x 2 bytes = 8 bytes, so the affected palette
        * is (index >> 1) >> 2 = index >> 3.  Only that slot needs
-       * its expansion rebuilt. */
-      ppu_.refreshBgPaletteExpansion(index >> 3);
+       * its expansion rebuilt, which the PPU leaves until it next
+       * draws with it: games streaming palettes during HBlank write
+       * the same slot several times over before then. */
+      ppu_.bgPaletteChanged(index >> 3);
    }
 }
 
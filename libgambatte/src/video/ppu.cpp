@@ -44,6 +44,11 @@ using namespace gambatte;
                      EXPAND_ROW(0x80), EXPAND_ROW(0x90), EXPAND_ROW(0xA0), EXPAND_ROW(0xB0), \
                      EXPAND_ROW(0xC0), EXPAND_ROW(0xD0), EXPAND_ROW(0xE0), EXPAND_ROW(0xF0)
 
+// Interleaves one bitplane byte of a tile row, x-flipped in the upper half.
+// Tile rows go through here on every fetch rather than being kept decoded
+// per VRAM bank: a decoded row would only save one load and an add, and
+// keeping it current would need every VRAM write (CPU, HDMA, state loads,
+// the frontend's memory map) to go through the PPU.
 static unsigned short const expand_lut[0x200] = {
 	EXPAND_TABLE,
 
@@ -166,6 +171,128 @@ static int loadTileDataByte1(PPUPriv const &p) {
 	                     + ((-(p.nattrib >> 6 & 1) ^ yoffset) & 7) * 2 + 1];
 }
 
+// Brings bgPaletteExpanded up to date with bgPalette, for the palettes
+// changed since it was last used.
+static void expandBgPalettes(PPUPriv &p) {
+	for (unsigned id = 0; id < 8; ++id) {
+		if (!(p.bgPaletteStale >> id & 1))
+			continue;
+
+		video_pixel_t const *const pal = p.bgPalette + id * 4;
+
+		for (unsigned b = 0; b < 256; ++b) {
+			p.bgPaletteExpanded[id][b][0] = pal[b      & 3];
+			p.bgPaletteExpanded[id][b][1] = pal[b >> 2 & 3];
+			p.bgPaletteExpanded[id][b][2] = pal[b >> 4 & 3];
+			p.bgPaletteExpanded[id][b][3] = pal[b >> 6    ];
+		}
+	}
+
+	p.bgPaletteStale = 0;
+}
+
+// Draws the whole current line, background and sprites, the way mode 3
+// does when nothing it looks at changes before the end of the line and the
+// window stays off. Needs the sprite list M3Start sets up.
+static void drawLine(PPUPriv &p) {
+	unsigned const yoffset = p.scy + p.lyCounter.ly();
+	unsigned char const *const tileMapLine = p.vram + (p.lcdc << 7 & 0x400)
+	                                       + (yoffset & 0xF8) * 4 + 0x1800;
+	unsigned const tileline = yoffset & 7;
+	unsigned const xoffset = p.scx & 7;
+	unsigned short tilewords[21];
+	unsigned char attribs[21];
+	video_pixel_t line[21 * 8];
+
+	for (unsigned i = 0; i < 21; ++i) {
+		unsigned const tileMapXpos = ((p.scx >> 3) + i) & 0x1F;
+		unsigned const tno = tileMapLine[tileMapXpos];
+		unsigned tileword, nattrib = 0;
+
+		if (p.cgb) {
+			nattrib = tileMapLine[tileMapXpos + 0x2000];
+
+			unsigned const tdo = (tileline * 2 + (~p.lcdc & 0x10) * 0x100) & ~(tno << 5);
+			unsigned char const *const td = p.vram + tno * 16
+			                              + ((nattrib & attr_yflip) ? tdo ^ 14 : tdo)
+			                              + (nattrib << 10 & 0x2000);
+			unsigned short const *const explut = expand_lut + (nattrib << 3 & 0x100);
+			tileword = explut[td[0]] + explut[td[1]] * 2;
+		} else if (lcdcBgEn(p)) {
+			unsigned const tileIndexSign = ~p.lcdc << 3 & 0x80;
+			unsigned char const *const td = p.vram + tileIndexSign * 32 + tileline * 2
+			                              + tno * 16 - (tno & tileIndexSign) * 32;
+			tileword = expand_lut[td[0]] + expand_lut[td[1]] * 2;
+		} else
+			tileword = 0;
+
+		tilewords[i] = tileword;
+		attribs[i] = nattrib;
+		std::memcpy(line + i * 8,     p.bgPaletteExpanded[nattrib & 7][tileword & 0xFF], 4 * sizeof *line);
+		std::memcpy(line + i * 8 + 4, p.bgPaletteExpanded[nattrib & 7][tileword >> 8  ], 4 * sizeof *line);
+	}
+
+	video_pixel_t *const dst = p.framebuf.fbline();
+	std::memcpy(dst, line + xoffset, 160 * sizeof *dst);
+
+	unsigned numSprites = 0;
+	while (p.spriteList[numSprites].spx < 168)
+		++numSprites;
+
+	if (!lcdcObjEn(p) || !numSprites)
+		return;
+
+	// Sprites go on back to front and the front one decides a pixel: the
+	// first in the (x-sorted) list on the DMG, the first in OAM on the CGB.
+	unsigned char order[10];
+	for (unsigned i = 0; i < numSprites; ++i)
+		order[i] = numSprites - 1 - i;
+
+	if (p.cgb) {
+		for (unsigned i = 1; i < numSprites; ++i) {
+			unsigned char const s = order[i];
+			unsigned j = i;
+
+			for (; j > 0 && p.spriteList[order[j - 1]].oampos < p.spriteList[s].oampos; --j)
+				order[j] = order[j - 1];
+
+			order[j] = s;
+		}
+	}
+
+	unsigned char const *const oam = p.spriteMapper.oamram();
+
+	for (unsigned i = 0; i < numSprites; ++i) {
+		PPUPriv::Sprite const &sprite = p.spriteList[order[i]];
+		unsigned const tile   = oam[sprite.oampos + 2] * 16;
+		unsigned const attrib = oam[sprite.oampos + 3];
+		unsigned const spline = ((attrib & attr_yflip) ? sprite.line ^ 15 : sprite.line) * 2;
+		unsigned char const *const td = p.vram + (attrib << 10 & p.cgb * 0x2000)
+		                              + (lcdcObj2x(p) ? (tile & ~16) | spline : tile | (spline & ~16));
+		unsigned spword = expand_lut[td[0] + (attrib << 3 & 0x100)]
+		                + expand_lut[td[1] + (attrib << 3 & 0x100)] * 2;
+		video_pixel_t const *const spPalette = p.spPalette
+			+ (p.cgb && !p.dmgMode ? (attrib & 7) * 4 : attrib >> 2 & 4);
+
+		for (int x = int(sprite.spx) - 8; spword; ++x, spword >>= 2) {
+			if (!(spword & 3) || x < 0 || x >= 160)
+				continue;
+
+			unsigned const pos = x + xoffset;
+			unsigned const twdata = tilewords[pos >> 3] >> (pos & 7) * 2 & 3;
+			unsigned const bgattrib = attribs[pos >> 3];
+
+			if (twdata && ((attrib | bgattrib) & attr_bgpriority) && (!p.cgb || lcdcBgEn(p)))
+				dst[x] = p.bgPalette[(bgattrib & 7) * 4 + twdata];
+			else
+				dst[x] = spPalette[spword & 3];
+		}
+	}
+}
+
+static long plainM3Cycles(PPUPriv const &p);
+static void drawLineAtOnce(PPUPriv &p, long m3cycles);
+
 namespace M3Start {
 	static void f0(PPUPriv &p) {
 		p.xpos = 0;
@@ -243,6 +370,10 @@ namespace M3Start {
 		p.xpos = 0;
 		p.endx = 8 - (p.scx & 7);
 
+		long const m3cycles = plainM3Cycles(p);
+		if (m3cycles >= 0 && p.cycles >= m3cycles)
+			return drawLineAtOnce(p, m3cycles);
+
 		static PPUState const *const flut[8] = {
 			&M3Loop::Tile::f0_,
 			&M3Loop::Tile::f1_,
@@ -340,8 +471,8 @@ static void doFullTilesUnrolledDmg(PPUPriv &p, int const xend, video_pixel_t *co
 				 * so the missed log shows
 				 * "no vectype for stmt: _ = bgPalette[_];" at every
 				 * call site) into two 16-byte memcpys.  The
-				 * expansion is rebuilt by LCD on every BG palette
-				 * write via refreshBgPaletteExpansion(0). */
+				 * expansion is brought up to date on entry to
+				 * doFullTilesUnrolled after BG palette writes. */
 				{
 					unsigned const lo = ntileword & 0xFF;
 					unsigned const hi = ntileword >> 8;
@@ -694,6 +825,118 @@ static void doFullTilesUnrolledCgb(PPUPriv &p, int const xend, video_pixel_t *co
 	p.xpos = xpos;
 }
 
+static void loadSpriteWord(PPUPriv &p, int const entry) {
+	unsigned char const *const oam = p.spriteMapper.oamram();
+	unsigned const tile   = oam[p.spriteList[entry].oampos + 2] * 16;
+	unsigned const attrib = oam[p.spriteList[entry].oampos + 3];
+	unsigned const spline = (  (attrib & attr_yflip)
+	                         ? p.spriteList[entry].line ^ 15
+	                         : p.spriteList[entry].line     ) * 2;
+	unsigned char const *const td = p.vram + (attrib << 10 & p.cgb * 0x2000)
+	                              + (lcdcObj2x(p) ? (tile & ~16) | spline : tile | (spline & ~16));
+
+	p.spwordList[entry] = expand_lut[td[0] + (attrib << 3 & 0x100)]
+	                    + expand_lut[td[1] + (attrib << 3 & 0x100)] * 2;
+	p.spriteList[entry].attrib = attrib;
+}
+
+static void loadNextTile(PPUPriv &p, unsigned char const *const tileMapLine,
+		unsigned const tileline, unsigned const tileMapXpos) {
+	unsigned const tno = tileMapLine[tileMapXpos & 0x1F];
+
+	if (p.cgb) {
+		unsigned const nattrib = tileMapLine[(tileMapXpos & 0x1F) + 0x2000];
+		unsigned const tdo = (tileline * 2 + (~p.lcdc & 0x10) * 0x100) & ~(tno << 5);
+		unsigned char const *const td = p.vram + tno * 16
+		                              + ((nattrib & attr_yflip) ? tdo ^ 14 : tdo)
+		                              + (nattrib << 10 & 0x2000);
+		unsigned short const *const explut = expand_lut + (nattrib << 3 & 0x100);
+		p.ntileword = explut[td[0]] + explut[td[1]] * 2;
+		p.nattrib   = nattrib;
+	} else {
+		unsigned const tileIndexSign = ~p.lcdc << 3 & 0x80;
+		unsigned char const *const td = p.vram + tileIndexSign * 32 + tileline * 2
+		                              + tno * 16 - (tno & tileIndexSign) * 32;
+		p.ntileword = expand_lut[td[0]] + expand_lut[td[1]] * 2;
+	}
+}
+
+// Counterpart of doFullTilesUnrolledDmg/Cgb for when there is no frame buffer.
+// Spends the same cycles and leaves the same fetcher and sprite state behind,
+// but only fetches the last tile of a run and draws nothing.
+static void skipFullTiles(PPUPriv &p, int const xend,
+		unsigned char const *const tileMapLine, unsigned const tileline, unsigned tileMapXpos) {
+	int xpos = p.xpos;
+
+	do {
+		int nextSprite = p.nextSprite;
+
+		if (int(p.spriteList[nextSprite].spx) < xpos + 8) {
+			int cycles = p.cycles - 8;
+
+			if (p.cgb || lcdcObjEn(p)) {
+				cycles -= std::max(11 - (int(p.spriteList[nextSprite].spx) - xpos), 6);
+
+				for (unsigned i = nextSprite + 1; int(p.spriteList[i].spx) < xpos + 8; ++i)
+					cycles -= 6;
+
+				if (cycles < 0)
+					break;
+
+				p.cycles = cycles;
+
+				do {
+					loadSpriteWord(p, nextSprite);
+					++nextSprite;
+				} while (int(p.spriteList[nextSprite].spx) < xpos + 8);
+			} else {
+				if (cycles < 0)
+					break;
+
+				p.cycles = cycles;
+
+				do {
+					++nextSprite;
+				} while (int(p.spriteList[nextSprite].spx) < xpos + 8);
+			}
+
+			p.nextSprite = nextSprite;
+		} else if (nextSprite-1 < 0 || int(p.spriteList[nextSprite-1].spx) <= xpos - 8) {
+			if (!(p.cycles & ~7))
+				break;
+
+			int n = ((  xend + 7 < int(p.spriteList[nextSprite].spx)
+			          ? xend + 7 : int(p.spriteList[nextSprite].spx)) - xpos) & ~7;
+			n = (p.cycles & ~7) < n ? p.cycles & ~7 : n;
+			p.cycles -= n;
+			xpos += n;
+			tileMapXpos += n >> 3;
+			loadNextTile(p, tileMapLine, tileline, tileMapXpos - 1);
+			continue;
+		} else {
+			int cycles = p.cycles - 8;
+			if (cycles < 0)
+				break;
+
+			p.cycles = cycles;
+		}
+
+		int i = nextSprite - 1;
+
+		do {
+			int pos = int(p.spriteList[i].spx) - xpos;
+			p.spwordList[i] >>= pos * 2 >= 0 ? 16 - pos * 2 : 16 + pos * 2;
+			--i;
+		} while (i >= 0 && int(p.spriteList[i].spx) > xpos - 8);
+
+		loadNextTile(p, tileMapLine, tileline, tileMapXpos);
+		++tileMapXpos;
+		xpos = xpos + 8;
+	} while (xpos < xend);
+
+	p.xpos = xpos;
+}
+
 static void doFullTilesUnrolled(PPUPriv &p) {
 	int xpos = p.xpos;
 	int const xend = static_cast<int>(p.wx) < xpos || p.wx >= 168
@@ -719,6 +962,12 @@ static void doFullTilesUnrolled(PPUPriv &p) {
 		tileline    = (p.scy + p.lyCounter.ly()) & 7;
 	}
 
+	if (!p.framebuf.fb())
+		return skipFullTiles(p, xend, tileMapLine, tileline, tileMapXpos);
+
+	if (p.bgPaletteStale)
+		expandBgPalettes(p);
+
 	if (xpos < 8) {
 		video_pixel_t prebuf[16];
 
@@ -764,6 +1013,16 @@ static void plotPixel(PPUPriv &p) {
 			p.winDrawState |= win_draw_start;
 	}
 
+	if (!p.framebuf.fb()) {
+		// nothing to draw, but the sprite words still shift out
+		for (int i = p.nextSprite - 1; i >= 0 && int(p.spriteList[i].spx) > xpos - 8; --i)
+			p.spwordList[i] >>= 2;
+
+		p.xpos = xpos + 1;
+		p.tileword = tileword >> 2;
+		return;
+	}
+
 	unsigned const twdata = tileword & ((p.lcdc & 1) | p.cgb) * 3;
 	video_pixel_t pixel = p.bgPalette[twdata + (p.attrib & 7) * 4];
 	int i = static_cast<int>(p.nextSprite) - 1;
@@ -1406,6 +1665,42 @@ namespace M3Start {
 	}
 }
 
+// Cycles from the end of M3Start to the end of mode 3, or -1 if the window
+// can start somewhere on the line. Exact as long as nothing mode 3 looks at
+// changes in the meantime, which is a given while update has cycles left.
+static long plainM3Cycles(PPUPriv const &p) {
+	unsigned const ly = p.lyCounter.ly();
+
+	if ((p.winDrawState & win_draw_started)
+			|| (p.wx < 167 && (p.weMaster || (p.wy2 == ly && lcdcWinEn(p))))) {
+		return -1;
+	}
+
+	return M3Loop::Tile::predictCyclesUntilXpos_fn(p, 0, p.endx, ly, 0,
+		p.weMaster, p.winDrawState, std::min(p.scx & 7, 5), 167, 1 - p.cgb);
+}
+
+// Skips mode 3 straight to its end, drawing the line with drawLine rather
+// than pixel by pixel. The fetcher registers are left as they were, since
+// the next line fetches afresh before any of it shows.
+static void drawLineAtOnce(PPUPriv &p, long const m3cycles) {
+	p.cycles -= m3cycles;
+	p.xpos = 168;
+	p.endx = 168;
+
+	while (p.spriteList[p.nextSprite].spx < 168)
+		++p.nextSprite;
+
+	if (p.framebuf.fb()) {
+		if (p.bgPaletteStale)
+			expandBgPalettes(p);
+
+		drawLine(p);
+	}
+
+	return M3Loop::xpos168(p);
+}
+
 namespace M2_Ly0 {
 	static unsigned predictCyclesUntilXpos_f0(PPUPriv const &p,
 			unsigned winDrawState, int targetx, unsigned cycles) {
@@ -1486,11 +1781,11 @@ PPUPriv::PPUPriv(NextM0Time &nextM0Time, unsigned char const *const oamram, unsi
 {
 	std::memset(spriteList, 0, sizeof spriteList);
 	std::memset(spwordList, 0, sizeof spwordList);
-	/* The expansion will be properly filled by LCD::refreshPalettes()
-	 * via PPU::refreshBgPaletteExpansion() before the first frame is
-	 * rendered, but zero it to keep the struct deterministic at
+	/* The expansion gets filled in from bgPalette before anything is
+	 * drawn with it, but zero it to keep the struct deterministic at
 	 * construction (saves don't carry derived state). */
 	std::memset(bgPaletteExpanded, 0, sizeof bgPaletteExpanded);
+	bgPaletteStale = 0xFF;
 }
 
 static void saveSpriteList(PPUPriv const &p, SaveState &ss) {